@@ -29,11 +29,8 @@ void callback(float* out, float* in, unsigned buffer, unsigned rate, unsigned ou
       stftTwo.updateInput(playerTwoSample);
       
       if(stftOne.isFFTReady() && stftTwo.isFFTReady()){
-        //multiply the magnitude of each bin
-        for(int i = 0; i <= stftOne.getNumberOfBins(); i++){
-          float newMagnitude = stftOne.getBinMagnitude(i) * stftTwo.getBinMagnitude(i);
-          stftOne.setBinMagnitude(i, newMagnitude);
-        }
+        //multiply every bin of stftOne by the matching bin of stftTwo
+        stftOne.multiplySpectrum(stftTwo);
       }
       stftOne.updateOutput();
       mB.stopTiming();
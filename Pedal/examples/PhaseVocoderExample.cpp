@@ -0,0 +1,64 @@
+//include functionality of a basic app
+#include "example_app.hpp"
+
+#include "pedal/PhaseVocoder.hpp"
+#include "pedal/Buffer.hpp"
+#include "pedal/MicroBenchmark.hpp"
+Buffer soundFile;
+PhaseVocoder liveVocoder;//pitch shifts the live input
+PhaseVocoder bufferVocoder;//pitch shifts and time stretches the soundfile
+MicroBenchmark mB;
+//========================Audio Callback
+void callback(float* out, float* in, unsigned buffer, unsigned rate, unsigned outputChannels,
+              unsigned inputChannels, double time, pdlExampleApp* app) {
+    //slider is in semitones, the vocoder expects a ratio
+    float pitchRatio = std::pow(2.0f, pdlGetSlider(app, 0) / 12.0f);
+    liveVocoder.setPitchRatio(pitchRatio);
+    bufferVocoder.setPitchRatio(pitchRatio);
+    bufferVocoder.setTimeRatio(pdlGetSlider(app, 1));
+    liveVocoder.setPhaseLocking(pdlGetToggle(app, 0));
+    bufferVocoder.setPhaseLocking(pdlGetToggle(app, 0));
+    bool useLiveInput = pdlGetToggle(app, 1);
+
+    for (unsigned i = 0; i < buffer; i += 1) {//for entire buffer of frames
+      float output = 0.0f;
+      mB.startTiming();
+      if(useLiveInput){
+        output = liveVocoder.processSample(in[inputChannels * i]);
+      }else{
+        output = bufferVocoder.generateSample();
+      }
+      mB.stopTiming();
+      out[outputChannels * i] = output * 0.5f;
+      out[outputChannels * i + 1] = output * 0.5f;
+    }
+}
+//======================main loop
+int main() {
+    //make an app (a pointer to an app, actually)
+    pdlExampleApp* app = pdlInitExampleApp(callback);
+    if (!app) {//if app doesn't succesfully allocate
+      return 1;//cancel program, return 1
+    }
+    pdlSettings::sampleRate = pdlExampleAppGetSamplingRate(app);
+    pdlSettings::bufferSize = pdlExampleAppGetBufferSize(app);
+    mB.initialize("phase vocoder", 100000);
+    soundFile.loadSoundFile("ding.wav");
+    bufferVocoder.setBuffer(&soundFile);
+    // Add your GUI elements here
+    pdlAddSlider(app, 0, "pitch (semitones)", -12.0f, 12.0f, 0.0f);
+    pdlAddSlider(app, 1, "time stretch", 0.25f, 4.0f, 1.0f);
+    pdlAddToggle(app, 0, "phase locking", true);
+    pdlAddToggle(app, 1, "live input", false);
+
+    //begin the app--------
+    pdlStartExampleApp(app);
+    while (pdlRunExampleApp(app)) {//run forever
+        pdlUpdateExampleApp(app);//run the application
+    }
+    if(mB.getCompleteFlag()){
+      mB.printHighlites();
+    }
+    //the application has stopped running, 
+    pdlDeleteExampleApp(app);//free the app from memory
+}
@@ -42,6 +42,9 @@
   #endif
   #define AUDIOFFT_OOURA_USED
   #include <vector>
+  #include <map>
+  #include <memory>
+  #include <mutex>
 #endif
 
 
@@ -109,7 +112,8 @@ namespace audiofft
       detail::AudioFFTImpl(),
       _size(0),
       _ip(),
-      _w(),
+      _w(nullptr),
+      _tables(),
       _buffer()
     {
     }
@@ -121,14 +125,13 @@ namespace audiofft
     {
       if (_size != size)
       {
-        _ip.resize(2 + static_cast<int>(std::sqrt(static_cast<double>(size))));
-        _w.resize(size / 2);
+        _tables = getSharedTables(size);
+        // The bit reversal area of _ip is rewritten by every transform, so each
+        // instance keeps its own copy. The twiddle factors are only read.
+        _ip = _tables->ip;
+        _w = const_cast<double*>(_tables->w.data());
         _buffer.resize(size);
         _size = size;
-
-        const int size4 = static_cast<int>(_size) / 4;
-        makewt(size4, _ip.data(), _w.data());
-        makect(size4, _ip.data(), _w.data() + size4);
       }
     }
 
@@ -137,7 +140,7 @@ namespace audiofft
       // Convert into the format as required by the Ooura FFT
       detail::ConvertBuffer(_buffer.data(), data, _size);
 
-      rdft(static_cast<int>(_size), +1, _buffer.data(), _ip.data(), _w.data());
+      rdft(static_cast<int>(_size), +1, _buffer.data(), _ip.data(), _w);
 
       // Convert back to split-complex
       {
@@ -173,16 +176,47 @@ namespace audiofft
         _buffer[1] = re[_size / 2];
       }
 
-      rdft(static_cast<int>(_size), -1, _buffer.data(), _ip.data(), _w.data());
+      rdft(static_cast<int>(_size), -1, _buffer.data(), _ip.data(), _w);
 
       // Convert back to split-complex
       detail::ScaleBuffer(data, _buffer.data(), 2.0 / static_cast<double>(_size), _size);
     }
 
   private:
+    // Pedal modification: twiddle factors depend only on the size, so they are
+    // calculated once per size and shared (read-only) by every instance in the
+    // process. Only the scratch buffers are private to an instance. Tables are
+    // released when the last instance using them is destroyed.
+    struct Tables
+    {
+      std::vector<int> ip;
+      std::vector<double> w;
+    };
+
+    std::shared_ptr<const Tables> getSharedTables(size_t size)
+    {
+      static std::mutex cacheMutex;
+      static std::map<size_t, std::weak_ptr<const Tables>> cache;
+      std::lock_guard<std::mutex> lock(cacheMutex);
+      std::shared_ptr<const Tables> tables = cache[size].lock();
+      if (!tables)
+      {
+        std::shared_ptr<Tables> newTables = std::make_shared<Tables>();
+        newTables->ip.resize(2 + static_cast<int>(std::sqrt(static_cast<double>(size))));
+        newTables->w.resize(size / 2);
+        const int size4 = static_cast<int>(size) / 4;
+        makewt(size4, newTables->ip.data(), newTables->w.data());
+        makect(size4, newTables->ip.data(), newTables->w.data() + size4);
+        tables = newTables;
+        cache[size] = tables;
+      }
+      return tables;
+    }
+
     size_t _size;
     std::vector<int> _ip;
-    std::vector<double> _w;
+    double* _w;
+    std::shared_ptr<const Tables> _tables;
     std::vector<double> _buffer;
 
     void rdft(int n, int isgn, double *a, int *ip, double *w)
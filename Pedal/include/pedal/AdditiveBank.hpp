@@ -0,0 +1,119 @@
+#ifndef AdditiveBank_hpp
+#define AdditiveBank_hpp
+
+#include <cmath>
+#include <vector>
+#include "../../external/AudioFFT.h"
+#include "pdlSettings.hpp"
+#include "utilities.hpp"
+/*
+A bank of sine partials, for additive synthesis with hundreds of them
+per voice (summing that many TSine or WTSine objects works, but each
+keeps its own phase and table lookups).
+
+Each partial has a frequency, an amplitude and a phase. Changes made
+between two render() calls are reached by the end of the next block:
+amplitudes ramp linearly and frequencies glide linearly, so partials
+can be moved every block without clicks. Partials at or above nyquist
+fade to silence instead of aliasing.
+
+Two ways to render them:
+OSCILLATORS (default) - every partial is a rotating phasor (see TSine's
+  QUADRATURE mode), eight at a time in one loop so the compiler can
+  keep them in vector registers. Exact, and cost grows with the
+  number of partials times the number of samples.
+INVERSE_FFT - each partial is drawn into a spectrum as the few bins of
+  a window's main lobe, and one inverse FFT makes a whole hop of
+  output (see bottom). Cost grows with the number of partials per hop,
+  so it is cheaper for very many partials. Frequencies and amplitudes
+  change once per hop rather than per sample, and output follows
+  changes about two hops (fftSize / 2) later.
+
+AdditiveBank bank(512);
+float amplitudes[512];//1/n for a saw wave
+for(int i = 0; i < 512; i++){amplitudes[i] = 0.5f / (i + 1);}
+bank.setHarmonics(55.0f, amplitudes, 512);
+...
+bank.render(output, bufferSize);//output is replaced
+*/
+class AdditiveBank{
+  public:
+  enum class Mode{
+    OSCILLATORS,//a phasor per partial (default)
+    INVERSE_FFT//overlap-added inverse FFTs, for very many partials
+  };
+  AdditiveBank(int maximumPartials = 512);
+
+  void render(float* output, int numberOfSamples);//output is replaced
+  void reset();//every phase back to 0, fading in again from silence
+
+  void setNumberPartials(int newNumberPartials);//up to maximumPartials
+  void setPartial(int index, float newFrequency, float newAmplitude);
+  void setFrequency(int index, float newFrequency);
+  void setAmplitude(int index, float newAmplitude);
+  void setPhase(int index, float newPhase);//(radians) jumps, doesn't ramp
+  //partial i at (i + 1) * fundamental, for the first numberAmplitudes partials
+  void setHarmonics(float fundamental, const float* amplitudes, int numberAmplitudes);
+  void setMode(Mode newMode);//continues every partial from the same phase
+  void setFFTSize(int powerOfTwo);//INVERSE_FFT mode, 64 or more (1024 by default)
+
+  int getMaximumPartials();
+  int getNumberPartials();
+  float getFrequency(int index);//the latest set
+  float getAmplitude(int index);
+  Mode getMode();
+  int getFFTSize();
+  int getHopSize();//fftSize / 4, INVERSE_FFT only
+
+  private:
+  static const int laneCount = 8;//partials per tile in the OSCILLATORS loop
+  static const int lobeHalfWidth = 4;//bins either side of a partial (INVERSE_FFT)
+  static const int lobeOversampling = 32;//lobe table points per bin
+  template<bool glide>
+  void renderTile(int first, float* output, int numberOfSamples);
+  void renderOscillators(float* output, int numberOfSamples);
+  void renderFrames(float* output, int numberOfSamples);
+  void synthesizeFrame();//the next hop of INVERSE_FFT output
+  void preparePhasors();//INVERSE_FFT phases back to the current output time
+  void prepareFrames();//from the current phases
+  void calculateLobe();//main lobe and synthesis window for fftSize
+  bool isAudible(float frequency);
+  Mode mode;
+  int maximumPartials;
+  int numberPartials;
+  //the partials, one array per property, padded to a whole tile with silent partials
+  std::vector<float> sine, cosine;//the phasor of each partial, at 'phase'
+  std::vector<float> rotationSine, rotationCosine;//one sample of rotation, at 'frequency'
+  std::vector<float> targetRotationSine, targetRotationCosine;//at 'targetFrequency'
+  std::vector<float> frequency, targetFrequency;
+  std::vector<float> amplitude, targetAmplitude;//amplitude is 0.0 above nyquist
+  std::vector<double> phase;//in cycles, now (INVERSE_FFT: at the next frame's center)
+  //INVERSE_FFT
+  int fftSize, hopSize;
+  audiofft::AudioFFT fft;
+  std::vector<float> lobe;//window spectrum, 0 to lobeHalfWidth bins
+  std::vector<float> synthesisWindow;//2 * hopSize, triangle divided by the window
+  std::vector<float> real, imaginary;
+  std::vector<float> frame;//fftSize, inverse FFT output
+  std::vector<float> ready, overlap;//hopSize each
+  int readIndex;//in 'ready'
+};
+#endif
+/*
+On INVERSE_FFT mode
+
+A steady sine, windowed, has a spectrum that is just the window's
+spectrum moved to the sine's frequency. For a Blackman-Harris window
+almost all of it (all but -92dB) lies within 4 bins either side, so a
+partial can be added to a spectrum by writing 9 bins from a table
+instead of calculating fftSize samples. After the inverse FFT, each
+frame is a sum of windowed sines. Its middle half is divided by the
+window and multiplied by a triangle, and triangles a hop apart add up
+to exactly 1.0, so overlap-adding hops gives the sines back at full
+amplitude. The frame's edges, where the window is nearly 0.0 and
+dividing by it would magnify every error, are never used.
+
+(Rodet and Depalle's FFT^-1 method.) Each partial costs 9 complex
+additions per hop rather than a hop's worth of samples, so with a hop
+of 256 it stays cheap long after OSCILLATORS mode has become expensive.
+*/
@@ -17,7 +17,8 @@ enum FilterType{
   BAND_REJECT,
   PEAK,
   LOW_SHELF,
-  HIGH_SHELF
+  HIGH_SHELF,
+  ALL_PASS//flat magnitude, phase shifts by 360 degrees around 'frequency'
 };
 
 class Biquad{
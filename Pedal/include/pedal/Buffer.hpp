@@ -4,6 +4,7 @@
 #include "utilities.hpp"
 #include "Interpolation.hpp"
 #include "TSine.hpp"
+#include "Resampler.hpp"
 #include <iostream>
 #include "../../external/dr_wav.h"//for reading and writing .wav
 
@@ -12,7 +13,9 @@ Buffers are used to store audio. Each buffer may contain
 a number of channels, but will contain only one channel by
 default. The channels are interleaved. A soundfile may be
 read in to a buffer, and a buffer may be saved to disk as
-a soundfile. Currently, only .wav is supported.
+a soundfile. Currently, only .wav is supported. Soundfiles
+at other sample rates are converted to pdlSettings::sampleRate
+as they are loaded.
 */
 class Buffer{
   public:
@@ -48,7 +51,7 @@ class Buffer{
   void writeSample(float inputSample, int index, int channel = 0);
   void addToSample(float inputSample, int index, int channel = 0);
   
-  void loadSoundFile(const char* soundFilePath);
+  bool loadSoundFile(const char* soundFilePath);//false if the file couldn't be read
   void writeSoundFile(const char* destinationPath);
 
   void setDuration(float newDuration);
@@ -56,12 +59,13 @@ class Buffer{
   
   void fillSineSweep(float lowFrequency = 20.0f, float highFrequency = 20000.0f);
   void fillNoise();
-  float getSample(float index, int channel = 0);//interleaved retrieval (can request floating point index)
-  float getSample(int index, int channel = 0);//non-interleaved retrieval
+  float getSample(float index, int channel = 0) const;//interleaved retrieval (can request floating point index)
+  float getSample(int index, int channel = 0) const;//non-interleaved retrieval
   float* getContent();
-  float getDuration();
-  unsigned long getDurationInSamples();
-  int getNumberChannels();
+  const float* getContent() const;//for shared, read only Buffers (see SamplePool)
+  float getDuration() const;
+  unsigned long getDurationInSamples() const;
+  int getNumberChannels() const;
   private:
   float* content = nullptr;//the actual buffer data
   unsigned numberChannels;//number of channels
@@ -1,13 +1,18 @@
 #ifndef BufferPlayer_hpp
 #define BufferPlayer_hpp
 
+#include <memory>
+#include <vector>
 #include "Buffer.hpp"
+#include "DiskBuffer.hpp"
+#include "SincTable.hpp"
 #include "utilities.hpp"
 
 enum InterpolationMode{
   NONE = 0, //may be noisey if speed != integer multiple of 1
   LINEAR, //lower cost, but great results
-  CUBIC //expensive but best
+  CUBIC, //more expensive, smoother
+  SINC //most expensive, no aliasing when sped up (see bottom)
 };
 
 enum PlayMode{
@@ -19,8 +24,12 @@ enum PlayMode{
 
 class BufferPlayer{
   public:
-  BufferPlayer(Buffer* reference = nullptr);//construct the player (with reference, if provided)
+  BufferPlayer(const Buffer* reference = nullptr);//construct the player (with reference, if provided)
+  BufferPlayer(DiskBuffer* stream);//play a file streamed from disk
+  BufferPlayer(std::shared_ptr<const Buffer> sample);//play a shared Buffer (see SamplePool)
   float update();//progress (and calculate if needed) new samples
+  //the next numberOfFrames frames, one array per channel (see 'On rendering' below)
+  void render(float** output, int numberOfFrames);
   
   void play();//make 'isPlaying' true
   void pause();//make 'isPlaying' false
@@ -28,16 +37,27 @@ class BufferPlayer{
   void reverseDirection();//move from forwards->backwards, or vice versa
   void setSpeed(float newSpeed);//change speed (1.0f is normal playback)
   void setPlayMode(PlayMode newPlayMode);//change mode
-  void setReference(Buffer* newReference);//assign new buffer
+  void setReference(const Buffer* newReference);//assign new buffer
+  void setReference(std::shared_ptr<const Buffer> newSample);//assign a shared buffer, held while playing it
+  void setReference(DiskBuffer* newStream);//assign a stream (forward playback only, see bottom)
   void setInterpolationMode(InterpolationMode newMode);//set interpolation mode
   float getSample(int channel = 0);//get a single sample
   float* getFrame();//get pointer to frame of samples
+  int getNumberChannels();
 
   private:
   PlayMode playMode; //internal storage of edge handling mode
   InterpolationMode interpolationMode;//how are inbetween samples calculated?
-  float* currentFrame = nullptr; //pointer to array of samples, size numberChannels
-  void assignDataFromReference(Buffer* reference);//reuseable function
+  std::vector<float> currentFrame;//one sample per channel
+  void assignDataFromReference(const Buffer* reference);//reuseable function
+  void assignDataFromStream(DiskBuffer* stream);
+  float updateStream();//update() when playing a DiskBuffer
+  template<InterpolationMode mode> void renderMode(float** output, int numberOfFrames);
+  template<InterpolationMode mode, PlayMode edge> void renderSpans(float** output, int numberOfFrames);
+  template<InterpolationMode mode> void renderWrappedFrame(float** output, int frame);
+  template<PlayMode edge> void handleEdge();//after the index may have left the buffer
+  void sincFrameWrapped(float* frame);//SINC at the index, wrapping around the ends
+  std::vector<float> sincWeights;//filter for the current position
   int wrapIndex(int inputIndex);//needed often for interpolation
   float index;//floating point, since playback can be between integer samples
   unsigned totalSampleCount;//total number of samples in reference
@@ -45,6 +65,46 @@ class BufferPlayer{
   float playSpeed;//playback speed. Can be negative.
   float direction;//direction storage (used to flip direction)
   bool isPlaying;//condition set by play/pause/stop functions
-  Buffer* bufferReference;//a pointer to a buffer class
+  const Buffer* bufferReference;//a pointer to a buffer class
+  std::shared_ptr<const Buffer> sampleHandle;//keeps a shared bufferReference alive
+  DiskBuffer* streamReference;//used instead of bufferReference when streaming
+  std::vector<float> streamFrames;//the two frames either side of the index
+  float streamPosition;//0.0 to 1.0 between those two frames
 };
-#endif 
\ No newline at end of file
+#endif
+
+//On streaming
+/*
+A DiskBuffer only holds the frames just ahead of the play position, so
+a streamed file can only be played forward. Speed is allowed (its sign
+is ignored), with NONE or LINEAR interpolation (CUBIC and SINC are
+played as LINEAR). LOOP and PING_PONG both loop the file; ONE_SHOT stops at the end.
+*/
+
+//On rendering
+/*
+render() produces the same samples as calling update() once per frame,
+but for a whole block at once. The interpolation and play modes are
+checked once per block, choosing a loop compiled for that combination.
+
+The index only needs checking near the ends of the buffer (where
+neighbouring samples wrap, or a loop or bounce happens). render()
+works out how many frames can be read before the index reaches an
+end, reads that whole span with no checks at all, then handles the
+frame at the end the careful way, and continues.
+
+float* channels[2] = {left, right};
+player.render(channels, bufferSize);
+*/
+
+//On SINC interpolation
+/*
+The other modes only look at the samples either side of the index, and
+when a sample is sped up its high frequencies fold back (alias) as
+audible noise. SINC reads a windowed sinc filter's worth of samples
+around the index (32 at normal speed). The filter's cutoff follows the
+speed (per block in render()), so anything that would alias is removed
+first. The filter gets longer as the cutoff falls, so the cost grows
+with speed: 32 taps up to 1x, 64 at 2x, 128 at 4x, 256 at 8x and above.
+Filters come from a table shared by every player (see SincTable).
+*/
@@ -2,43 +2,65 @@
 #define BufferedRMS_HPP
 
 #include <algorithm>
+#include <cmath>
+#include <vector>
 #include "utilities.hpp"
-#include "Buffer.hpp"
-#include "pedal/DebugTool.hpp"
 
 //Root Mean Squared
 //average adjusted accurately per sample
+/*
+The squared input of the last N samples is kept in a ring buffer. Each
+sample the newest square is added to a running total and the oldest is
+subtracted, so the cost does not depend on N.
+
+The ring buffer size is a power of two, so wrapping an index is a single
+bitwise 'and' rather than a division (or a call to Buffer, which checks
+every index it is given).
+
+Adding and subtracting floats forever lets rounding errors pile up in the
+running total; after hours it could even become negative. Every time the
+write index wraps around, the total is recomputed from the buffer, which
+throws the accumulated error away. The total itself is a double: a float
+total keeps the rounding error of a loud passage, which after a sudden
+drop of 60 dB can be a large part of the quiet level until the next wrap.
+See MultichannelRMS for many channels.
+*/
 class BufferedRMS{
   public:
   BufferedRMS(int samplePeriod = 16);//this tool is best suited for small periods
-  inline float process(float input);
+  inline float process(float input);//returns the RMS
+  void processBlock(const float* input, float* output, int numberOfSamples);//RMS of each sample
   void setSamplePeriod(int newSamplePeriod);//how many samples to average
   int getSamplePeriod();
-  float getSample();
-  
+  float getSample();//RMS
+  float getMeanSquare();//RMS without the sqrt (power); cheaper for metering in dB
+
   private:
-  Buffer sampleBuffer;
+  inline void update(float input);
+  void recalculateTotal();//remove accumulated rounding error
+  std::vector<float> squaredHistory;//power of two size
+  int indexMask;//size - 1
   int writeIndex;
   float periodReciprocal;//store
-  float currentSample;//output only calculated every N samples, so smooth
+  float currentSample;
+  float meanSquare;
   int samplesToAverage;//how many samples in an average?
-  int sampleCounter;//to keep track of how many we've added
-  float runningTotal;
-  DebugTool debugTool;
-
+  double runningTotal;//see the note above
 };
-inline float BufferedRMS::process(float input){
-  writeIndex = writeIndex%samplesToAverage;//wrap the index
-  //subtract what WAS in the buffer first
-  runningTotal -= sampleBuffer.getSample(writeIndex);
-  //debugTool.printOncePerBuffer(writeIndex);
-  //add its replacement to the total, then to buffer
+inline void BufferedRMS::update(float input){
   float squaredInput = input * input;//square the input
-  runningTotal += squaredInput;//add squared input to running total
-  sampleBuffer.writeSample(squaredInput, writeIndex);//add the squared input to the buffer
-  writeIndex++;//increment the index for next round
-  //record the sqrt of the current average
-  currentSample = sqrt(runningTotal * periodReciprocal);
+  //subtract the square leaving the window, add its replacement
+  int oldestIndex = (writeIndex - samplesToAverage) & indexMask;
+  runningTotal += static_cast<double>(squaredInput) - squaredHistory[oldestIndex];
+  squaredHistory[writeIndex] = squaredInput;
+  writeIndex = (writeIndex + 1) & indexMask;//increment and wrap
+  if(writeIndex == 0){recalculateTotal();}
+  //rounding may leave a tiny negative total after silence
+  meanSquare = std::max(static_cast<float>(runningTotal) * periodReciprocal, 0.0f);
+}
+inline float BufferedRMS::process(float input){
+  update(input);
+  currentSample = std::sqrt(meanSquare);
   return currentSample;//return value
 }
-#endif
\ No newline at end of file
+#endif
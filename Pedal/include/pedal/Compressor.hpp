@@ -1,9 +1,12 @@
 #ifndef Compressor_hpp
 #define Compressor_hpp
 
+#include <vector>
 #include "pedal/CircularBuffer.hpp"
 #include "pedal/BufferedRMS.hpp"
 #include "pedal/utilities.hpp"
+#include "pedal/FastMath.hpp"
+#include "pedal/LinkedDetector.hpp"
 /*
 This is a basic compressor. More specifically, this 
 is a dynamic compressor; it comresses the dynamic range
@@ -18,6 +21,11 @@ class Compressor{
 
   float process(float input);//main per-sample function
   float process(float input, float sideChain);//overload; if second input is given use side-chain mode
+  //linked multi-channel mode, see notes at bottom
+  using ChannelLink = LinkedDetector::Mode;//MAXIMUM (loudest channel) or RMS (all channels)
+  void setLinkedChannels(int numberOfChannels);//allocates, call before processLinked()
+  void setChannelLink(ChannelLink newChannelLink);
+  void processLinked(const float* input, float* output, int numberOfFrames);//interleaved frames
   
   void setThresholdDB(float newThresholdDB);//At what intensity does attenuation begin?
   void setRatio(float newRatio);//set attenuation ratio
@@ -39,6 +47,8 @@ class Compressor{
   float getReleaseTime();//(ms)
   float getLookAheadTime();//(ms)
   float getAnalysisTime();//(ms)
+  int getLinkedChannels();
+  ChannelLink getChannelLink();
 
   private:
   void updateGain(float input);
@@ -59,6 +69,8 @@ class Compressor{
   float lookAhead;//push analysis further ahead of 
   float linearMakeUpGain;//how much to scale the output
   float reductionTargetDB;//how much reduction is being attempted
+  //linked multi-channel mode
+  LinkedDetector linked;//one detector and delay line for every channel
 };
 #endif 
 
@@ -84,3 +96,15 @@ will be attenuated if the kick drum is loud enough. This works well
 as the two instruments share a lot of frequency components and have to
 fight eachother for space in a mix. 
 */
+//On linked channels
+/*
+A stereo (or surround) signal compressed by one compressor per channel
+will have different gain on each channel whenever one side is louder.
+The sound then moves toward the quieter side (image shifting).
+processLinked() uses a single detector for every channel: each frame is
+reduced to one value, either the loudest channel (MAXIMUM) or the RMS of
+all channels (RMS), and the resulting gain is applied to every channel.
+The channels share one interleaved delay line (see LinkedDetector, which
+Gate uses as well). Set the number of channels with setLinkedChannels()
+first, since it allocates memory.
+*/
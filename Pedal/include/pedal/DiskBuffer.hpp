@@ -0,0 +1,90 @@
+#ifndef DiskBuffer_hpp
+#define DiskBuffer_hpp
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "utilities.hpp"
+#include "../../external/dr_wav.h"//for reading .wav
+/*
+A DiskBuffer plays a sound file straight from disk. Unlike Buffer, the
+file is never loaded into memory as a whole; only a few seconds ahead
+of the play position are held at a time. Very long files (hours of
+field recordings) start immediately and use the same small amount of
+memory as short ones.
+
+Reading from disk may take any amount of time, which the audio thread
+can't wait for. A dedicated I/O thread reads ahead into a ring buffer
+and the audio thread only ever copies out of that ring buffer. The two
+threads never lock each other (see notes at bottom).
+
+If the disk can't keep up, readFrames() outputs silence for the missing
+frames (an underrun) rather than waiting. getUnderrunCount() reports how
+often this happened; a larger read-ahead time helps.
+
+BufferPlayer can play a DiskBuffer in place of a Buffer (forward only).
+*/
+class DiskBuffer{
+  public:
+  DiskBuffer(float readAheadTime = 2000.0f);//(ms) size of the ring buffer
+  ~DiskBuffer();
+  DiskBuffer(const DiskBuffer&) = delete;//owns a thread and an open file
+  DiskBuffer& operator=(const DiskBuffer&) = delete;
+
+  bool open(const char* soundFilePath);//starts the I/O thread, false if the file can't be read
+  void close();//stops the I/O thread
+  //Audio thread functions. These never block
+  int readFrames(float* output, int numberOfFrames);//interleaved, returns frames that were available
+  void seek(unsigned long frame);//next frames read will start here
+  void setLooping(bool shouldLoop);//at the end of the file, continue from the beginning
+
+  bool isOpen();
+  bool isFinished();//not looping, and every frame of the file has been read
+  bool getLooping();
+  int getNumberChannels();
+  unsigned getFileSampleRate();
+  unsigned long getDurationInSamples();//length of the file, in frames
+  unsigned long getUnderrunCount();//frames replaced by silence so far
+
+  private:
+  void readAhead();//I/O thread main loop
+  int capacity;//ring size in frames (power of two)
+  int indexMask;//capacity - 1
+  std::vector<float> ring;//interleaved
+  //each index only ever grows and is written by one thread only
+  std::atomic<unsigned long long> writeIndex;//I/O thread
+  std::atomic<unsigned long long> readIndex;//audio thread
+  //seeking: the audio thread asks, the I/O thread answers
+  std::atomic<unsigned long> seekTarget;
+  std::atomic<unsigned> seekRequest;//incremented for each request
+  std::atomic<unsigned> seekAnswer;//set to seekRequest when the ring is refilling
+  std::atomic<unsigned long long> seekStartIndex;//ring index where the new data begins
+  unsigned seekPending;//audio thread only: request waiting for an answer
+  std::atomic<bool> looping;
+  std::atomic<bool> endOfFile;//I/O thread read the last frame
+  std::atomic<bool> running;
+  std::atomic<unsigned long> underrunCount;
+  std::thread ioThread;
+  drwav wav;
+  bool fileIsOpen;
+  int numberChannels;
+  unsigned fileSampleRate;
+  unsigned long totalFrames;
+  float readAheadTime;
+};
+#endif
+
+//On lock-free ring buffers
+/*
+There is exactly one writer (the I/O thread) and one reader (the audio
+thread). Each keeps its own index, which only it may change; the other
+thread only reads it. The indices count every frame ever written or
+read (they never wrap); the position in the ring is index & indexMask.
+The number of frames waiting is writeIndex - readIndex, and the writer
+may fill capacity - (writeIndex - readIndex) frames.
+
+Seeking would require both indices to change at once. Instead the audio
+thread posts a request, the I/O thread seeks the file and answers with
+the ring index where the new data starts, and the audio thread jumps its
+own readIndex forward to that point (silence is output in the meantime).
+*/
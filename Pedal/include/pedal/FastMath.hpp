@@ -0,0 +1,162 @@
+#ifndef FastMath_hpp
+#define FastMath_hpp
+
+#define _USE_MATH_DEFINES
+#include <algorithm>//std::min, std::max
+#include <cmath>
+#include <cstdint>//std::uint32_t
+#include <cstring>//std::memcpy
+/*
+Fast approximations of common math functions.
+
+The standard library functions (std::atan2, std::sin, std::cos...) are
+accurate to the last bit of a float and must handle every special case
+(infinity, NaN, errno...). That work is wasted when the result is an
+audio sample or a bin phase. The functions below trade a small, bounded
+error for speed.
+
+Each function is written without branches (the ternary operators become
+'select' instructions) and without calls to the standard library. This
+allows the compiler to process several values at once (SIMD) when these
+functions are used inside a simple loop over an array (see the block
+versions at the bottom), such as:
+
+for(int i = 0; i < size; i++){
+  output[i] = fastAtan2(imaginary[i], real[i]);
+}
+
+Maximum errors are noted beside each function.
+*/
+
+//atan2 with a maximum error of about 0.00001 radians
+inline float fastAtan2(float y, float x){
+  float absoluteX = std::fabs(x);
+  float absoluteY = std::fabs(y);
+  float maximum = absoluteX > absoluteY ? absoluteX : absoluteY;
+  float minimum = absoluteX > absoluteY ? absoluteY : absoluteX;
+  //ratio is always in range 0 to 1, where the polynomial is accurate
+  float ratio = maximum > 0.0f ? minimum / maximum : 0.0f;
+  float ratioSquared = ratio * ratio;
+  //minimax polynomial approximation of atan() in range 0 to 1
+  float result = ratio * (0.99997726f + ratioSquared * (-0.33262347f +
+                 ratioSquared * (0.19354346f + ratioSquared * (-0.11643287f +
+                 ratioSquared * (0.05265332f + ratioSquared * -0.01172120f)))));
+  //move the result into the correct octant, then quadrant
+  result = absoluteY > absoluteX ? 1.57079632679f - result : result;
+  result = x < 0.0f ? 3.14159265359f - result : result;
+  result = y < 0.0f ? -result : result;
+  return result;
+}
+//sine of any phase (in radians) with a maximum error of about 0.0000002
+inline float fastSin(float phase){
+  //wrap phase to range -pi to pi
+  float turns = phase * 0.15915494309f;//phase / 2pi
+  turns += turns >= 0.0f ? 0.5f : -0.5f;//round away from 0 when truncated
+  phase -= static_cast<float>(static_cast<int>(turns)) * 6.28318530718f;
+  //sine is symmetrical about pi/2, fold into range -pi/2 to pi/2
+  phase = phase > 1.57079632679f ? 3.14159265359f - phase : phase;
+  phase = phase < -1.57079632679f ? -3.14159265359f - phase : phase;
+  //taylor series is accurate in this small range
+  float phaseSquared = phase * phase;
+  return phase * (1.0f + phaseSquared * (-1.6666667e-1f +
+                  phaseSquared * (8.3333333e-3f + phaseSquared * (-1.9841270e-4f +
+                  phaseSquared * (2.7557319e-6f + phaseSquared * -2.5052108e-8f)))));
+}
+//cosine is sine shifted by a quarter rotation
+inline float fastCos(float phase){
+  return fastSin(phase + 1.57079632679f);
+}
+//accuracy of the polynomial sines below. Each step up costs one more multiply-add
+enum class SineAccuracy{
+  LOW,//maximum error of about 0.00007 (-83dB)
+  MEDIUM,//about 0.0000006 (-124dB)
+  HIGH//about 0.0000002, as accurate as a float allows
+};
+//sine of a phase in cycles (1.0 is a whole rotation), for oscillators that
+//count their phase from 0 to 1. Minimax polynomials fitted over a quarter
+//cycle, so the error is spread evenly rather than growing toward the ends.
+//|cycles| should stay below about 1000000 (float precision is lost beyond that anyway)
+template<SineAccuracy accuracy = SineAccuracy::HIGH>
+inline float fastSinCycles(float cycles){
+  //wrap to range -0.5 to 0.5 (copysign, min and max are single SIMD instructions)
+  float x = cycles - static_cast<float>(static_cast<int>(cycles + std::copysign(0.5f, cycles)));
+  //sine is symmetrical about a quarter cycle, fold into range -0.25 to 0.25
+  x = std::min(x, 0.5f - x);
+  x = std::max(x, -0.5f - x);
+  float xSquared = x * x;
+  if(accuracy == SineAccuracy::LOW){
+    return x * (6.281280077f + xSquared * (-41.09524269f + xSquared * 73.58551475f));
+  }else if(accuracy == SineAccuracy::MEDIUM){
+    return x * (6.283164044f + xSquared * (-41.33714237f + xSquared * (81.34076889f +
+                xSquared * -70.99343328f)));
+  }else{
+    return x * (6.283185160f + xSquared * (-41.34165503f + xSquared * (81.60100407f +
+                xSquared * (-76.54978230f + xSquared * 39.53670608f))));
+  }
+}
+template<SineAccuracy accuracy = SineAccuracy::HIGH>
+inline float fastCosCycles(float cycles){
+  return fastSinCycles<accuracy>(cycles + 0.25f);
+}
+//log2 of a positive number, maximum error of about 0.000002
+//(0 returns -127 rather than -inf. The sign is ignored, so a negative number
+//returns log2 of its magnitude: fastLog2(-8.0f) is 3.0, not NaN)
+inline float fastLog2(float input){
+  //a float is stored as mantissa * 2^exponent, and log2(m * 2^e) = log2(m) + e.
+  //The exponent can be read directly from the bits of the float.
+  std::uint32_t bits;
+  std::memcpy(&bits, &input, sizeof(float));
+  int exponent = static_cast<int>((bits >> 23) & 0xFF) - 127;
+  bits = (bits & 0x007FFFFF) | 0x3F800000;//mantissa with exponent of 0 (range 1 to 2)
+  float mantissa;
+  std::memcpy(&mantissa, &bits, sizeof(float));
+  //center the mantissa around 1 (range 0.707 to 1.414) where the series is accurate
+  bool high = mantissa > 1.41421356f;
+  mantissa = high ? mantissa * 0.5f : mantissa;
+  exponent = high ? exponent + 1 : exponent;
+  //log2(m) = 2/ln(2) * atanh(s), where s = (m-1)/(m+1)
+  float s = (mantissa - 1.0f) / (mantissa + 1.0f);
+  float sSquared = s * s;
+  float logOfMantissa = s * (2.88539008f + sSquared * (0.96179669f +
+                        sSquared * (0.57707802f + sSquared * 0.41219858f)));
+  return static_cast<float>(exponent) + logOfMantissa;
+}
+//2 to the power of input, maximum relative error of about 0.0000015
+inline float fastExp2(float input){
+  //keep the result within the range of a float
+  input = input < -126.0f ? -126.0f : input;
+  input = input > 127.0f ? 127.0f : input;
+  //split into a whole part (exponent) and a fraction from -0.5 to 0.5
+  float rounding = input >= 0.0f ? 0.5f : -0.5f;
+  int whole = static_cast<int>(input + rounding);
+  float fraction = input - static_cast<float>(whole);
+  //2^f = e^(f * ln(2)), taylor series is accurate for small f
+  float x = fraction * 0.69314718f;
+  float powerOfFraction = 1.0f + x * (1.0f + x * (0.5f + x * (1.6666667e-1f +
+                          x * (4.1666667e-2f + x * (8.3333333e-3f + x * 1.3888889e-3f)))));
+  //2^whole is built directly from the bits of a float
+  std::uint32_t bits = static_cast<std::uint32_t>(whole + 127) << 23;
+  float powerOfWhole;
+  std::memcpy(&powerOfWhole, &bits, sizeof(float));
+  return powerOfWhole * powerOfFraction;
+}
+//amplitude to decibels, maximum error of about 0.00002dB
+//20 * log10(x) = 20 * log10(2) * log2(x)
+inline float fastAmplitudeToDB(float amplitude){
+  return 6.02059991f * fastLog2(amplitude);
+}
+//power (amplitude squared, such as a mean square) to decibels. No sqrt needed
+inline float fastPowerToDB(float power){
+  return 3.01029996f * fastLog2(power);
+}
+//decibels to amplitude, maximum relative error of about 0.0000015
+//10^(dB/20) = 2^(dB * log2(10) / 20)
+inline float fastDBToAmplitude(float dB){
+  return fastExp2(dB * 0.16609640f);
+}
+//block versions, process an entire array at once
+void fastAmplitudeToDB(const float* amplitudes, float* dBOutput, int size);
+void fastDBToAmplitude(const float* dBs, float* amplitudeOutput, int size);
+void fastSinCycles(const float* cycles, float* output, int size,
+                   SineAccuracy accuracy = SineAccuracy::HIGH);
+#endif
@@ -1,9 +1,12 @@
 #ifndef Gate_hpp
 #define Gate_hpp
 
+#include <vector>
 #include "pedal/CircularBuffer.hpp"
 #include "pedal/BufferedRMS.hpp"
 #include "pedal/utilities.hpp"
+#include "pedal/FastMath.hpp"
+#include "pedal/LinkedDetector.hpp"
 /*
 A gate makes quiet sounds more quiet. How much more
 quiet depends on how high the ratio is, and how quiet
@@ -17,6 +20,11 @@ class Gate{
   Gate();
   float process(float input);
   float process(float input, float sideChain);
+  //linked multi-channel mode, see notes at bottom
+  using ChannelLink = LinkedDetector::Mode;//MAXIMUM (loudest channel) or RMS (all channels)
+  void setLinkedChannels(int numberOfChannels);//allocates, call before processLinked()
+  void setChannelLink(ChannelLink newChannelLink);
+  void processLinked(const float* input, float* output, int numberOfFrames);//interleaved frames
 
   void setThresholdDB(float newThresholdDB);//signal below threshold triggers attenuation
   void setRatio(float newRatio);//set attenuation ratio
@@ -41,6 +49,8 @@ class Gate{
   float getReleaseTime();//(ms)
   float getLookAheadTime();//(ms)
   float getAnalysisTime();//(ms)
+  int getLinkedChannels();
+  ChannelLink getChannelLink();
   
   private:
   void updateGain(float input);
@@ -62,5 +72,13 @@ class Gate{
   float lookAhead;//push analysis further ahead of 
   float linearMakeUpGain;//how much to scale the output
   float reductionTargetDB;//how much reduction is being attempted
+  //linked multi-channel mode
+  LinkedDetector linked;//one detector and delay line for every channel
 };
-#endif
\ No newline at end of file
+#endif
+//On linked channels
+/*
+See the notes at the bottom of Compressor.hpp; the gate works the same
+way. One detector opens and closes the gate for every channel, so quiet
+channels are not cut while a louder channel is still playing.
+*/
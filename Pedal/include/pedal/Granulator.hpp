@@ -0,0 +1,94 @@
+#ifndef Granulator_hpp
+#define Granulator_hpp
+
+#include <memory>
+#include <vector>
+#include "Buffer.hpp"
+#include "WindowTable.hpp"
+#include "utilities.hpp"
+/*
+Granular synthesis: many short, overlapping pieces ('grains') of a
+sample, each faded in and out by a window, played together.
+
+Grains start 'density' times per second. As with ImpulseGenerator,
+deviation (0.0 to 1.0) makes the timing irregular and maskChance
+(0.0 to 1.0) skips some grains entirely. Each grain reads from around
+'position' in the source (0.0 is the start, 1.0 the end), and its
+length, pitch and place in the stereo field may vary at random too.
+
+All grains live in a pool allocated up front (maximumGrains), so no
+memory is allocated while running. When the pool is full, new grains
+are skipped. The window shape is read from a table (see WindowTable) rather than
+calculated, and render() plays each grain for the whole block in one
+loop, so thousands of grains may play at once.
+
+Granulator clouds(2000);
+clouds.setSource(&buffer);
+clouds.setDensity(10000.0f);//grains per second
+clouds.setGrainDuration(150.0f);//around 1500 grains at once
+...
+float* channels[2] = {left, right};
+clouds.render(channels, bufferSize);
+
+Grains read the first channel of the source.
+*/
+class Granulator{
+  public:
+  Granulator(int maximumGrains = 1024);
+
+  void render(float** output, int numberOfFrames);//stereo, output is replaced
+
+  void setSource(const Buffer* newSource);//stops every grain
+  void setSource(std::shared_ptr<const Buffer> newSource);//held for as long as it is the source
+  void setDensity(float newDensity);//grains per second
+  void setDeviation(float newDeviation);//0.0 is periodic, 1.0 is up to half a period early or late
+  void setMaskChance(float newMaskChance);//chance (0.0 to 1.0) that a grain is skipped
+  void setGrainDuration(float newDuration);//(ms)
+  void setDurationDeviation(float newDeviation);//0.0 to 1.0 of the duration, either way
+  void setPosition(float newPosition);//0.0 to 1.0 of the source
+  void setPositionDeviation(float newDeviation);//(ms) either way
+  void setSpeed(float newSpeed);//1.0f is the original pitch, negative plays backward
+  void setPitchDeviation(float newDeviation);//(semitones) either way
+  void setSpread(float newSpread);//0.0 (center) to 1.0 (anywhere between left and right)
+  void setAmplitude(float newAmplitude);//of each grain
+  void setEnvelope(Window::Mode newEnvelope);//shape grains fade in and out with
+
+  int getMaximumGrains();
+  int getActiveGrains();
+  float getDensity();
+  float getDeviation();
+  float getMaskChance();
+  float getGrainDuration();
+  float getPosition();
+  float getSpeed();
+  float getSpread();
+  Window::Mode getEnvelope();
+
+  private:
+  void startGrain(int offset);//begins 'offset' frames into the current block
+  void removeGrain(int grain);
+  static const int envelopeSize = 1024;
+  std::shared_ptr<const WindowTable> envelope;//shared with anything else using the same shape
+  Window::Mode envelopeMode;
+  //the grain pool, one array per property so the render loop reads them in order
+  int maximumGrains;
+  int activeGrains;
+  std::vector<double> readPosition;//in the source, frames
+  std::vector<float> readIncrement;
+  std::vector<float> envelopePhase;//0 to envelopeSize
+  std::vector<float> envelopeIncrement;
+  std::vector<float> leftGain, rightGain;
+  std::vector<int> framesLeft;
+  std::vector<int> startOffset;//into the current block, for grains that haven't begun
+  //scheduling
+  float framesUntilNextGrain;
+  float density, period, deviation, maskChance;
+  //grain properties
+  float grainDuration, durationDeviation;
+  float position, positionDeviation;
+  float speed, pitchDeviation;
+  float spread, amplitude;
+  const Buffer* source;
+  std::shared_ptr<const Buffer> sourceHandle;
+};
+#endif
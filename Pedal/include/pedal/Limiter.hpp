@@ -0,0 +1,145 @@
+#ifndef Limiter_hpp
+#define Limiter_hpp
+
+#include <cstdint>
+#include <vector>
+#include "pedal/utilities.hpp"
+/*
+A limiter is a compressor with an infinite ratio and an instant
+attack; no sample is allowed past the ceiling. An instant change in
+gain would distort the signal, so the limiter looks ahead. The input
+is delayed by the look-ahead time, which gives the gain time to ramp
+down smoothly before the peak arrives at the output.
+
+For each input sample the gain needed to keep that sample at the
+ceiling is calculated (ceiling / |input|). The gain actually applied
+must be the lowest needed gain of every sample in the look-ahead
+window. Searching the whole window every sample would cost more as
+the look-ahead grows; instead a 'monotonic deque' is kept (see notes
+at bottom), which costs about the same for any look-ahead time.
+
+The held gain then passes through a release smoother (gain may drop
+instantly but rises slowly) and a moving average with the same length
+as the look-ahead. The moving average turns the drop into a smooth
+ramp which is guaranteed to reach the needed gain exactly when the
+peak leaves the delay line.
+
+Memory for the longest look-ahead is allocated at construction.
+*/
+class Limiter{
+  public:
+  Limiter(float maximumLookAheadTime = 20.0f);//(ms) largest look-ahead that may be set
+  float process(float input);//main per-sample function
+  void processBlock(const float* input, float* output, int numberOfSamples);
+
+  void setCeilingDB(float newCeilingDB);//no output sample will exceed this
+  void setInputGainDB(float newInputGainDB);//push the input into the limiter
+  void setLookAheadTime(float newLookAheadTime);//(ms) also the attack time
+  void setReleaseTime(float newReleaseTime);//(ms)
+
+  float getSample();
+  float getLinearScalar();//gain currently applied to the output
+  float getCeilingDB();
+  float getInputGainDB();
+  float getLookAheadTime();//(ms)
+  float getReleaseTime();//(ms)
+  int getLatencyInSamples();//how far the output is delayed
+
+  private:
+  inline float processSample(float input);
+  void reset();//clear all history (used when look-ahead changes)
+  float currentSample;
+  float ceilingDB;
+  float linearCeiling;
+  float linearInputGain;
+  float lookAheadTime;
+  float releaseTime;
+  float releaseCoefficient;
+  int lookAheadInSamples;
+  int capacity;//size of every ring buffer below
+  std::int64_t sampleIndex;//count of processed samples (64 bits on every platform)
+  //delay line
+  std::vector<float> delayLine;
+  int delayWriteIndex;
+  //monotonic deque, stored as a ring buffer (sliding minimum of needed gain)
+  std::vector<float> dequeGains;
+  std::vector<std::int64_t> dequeIndices;//when each gain entered the window
+  int dequeFront;
+  int dequeSize;
+  //release smoother
+  float releasedGain;
+  //moving average
+  std::vector<float> averageHistory;
+  int averageWriteIndex;
+  double averageTotal;//double, since error would accumulate forever
+  float averageReciprocal;
+  float smoothedGain;
+};
+
+inline float Limiter::processSample(float input){
+  //1) gain needed so this sample doesn't exceed the ceiling
+  float scaledInput = input * linearInputGain;
+  float magnitude = std::fabs(scaledInput);
+  float neededGain = magnitude > linearCeiling ? linearCeiling / magnitude : 1.0f;
+
+  //2) lowest needed gain in the window (monotonic deque)
+  //remove every entry at the back that is not lower than the new one
+  while(dequeSize > 0){
+    int back = (dequeFront + dequeSize - 1) % capacity;
+    if(dequeGains[back] < neededGain){break;}
+    dequeSize--;
+  }
+  int newBack = (dequeFront + dequeSize) % capacity;
+  dequeGains[newBack] = neededGain;
+  dequeIndices[newBack] = sampleIndex;
+  dequeSize++;
+  //remove the front if it has left the window
+  if(dequeIndices[dequeFront] <= sampleIndex - (lookAheadInSamples + 1)){
+    dequeFront = (dequeFront + 1) % capacity;
+    dequeSize--;
+  }
+  float heldGain = dequeGains[dequeFront];
+
+  //3) release: drop instantly, rise slowly
+  if(heldGain < releasedGain){
+    releasedGain = heldGain;
+  }else{
+    releasedGain = heldGain + (releasedGain - heldGain) * releaseCoefficient;
+  }
+
+  //4) moving average over the look-ahead window
+  averageTotal += releasedGain - averageHistory[averageWriteIndex];
+  averageHistory[averageWriteIndex] = releasedGain;
+  averageWriteIndex++;
+  if(averageWriteIndex > lookAheadInSamples){averageWriteIndex = 0;}
+  smoothedGain = static_cast<float>(averageTotal) * averageReciprocal;
+
+  //5) apply the gain to the delayed input
+  float delayedInput = delayLine[delayWriteIndex];//written 'lookAhead' samples ago
+  delayLine[delayWriteIndex] = scaledInput;
+  delayWriteIndex++;
+  if(delayWriteIndex >= lookAheadInSamples){delayWriteIndex = 0;}
+  if(lookAheadInSamples == 0){delayedInput = scaledInput;}//no delay line
+
+  sampleIndex++;
+  //the gains are exact only to rounding, which can leave a sample a bit over
+  currentSample = clamp(delayedInput * smoothedGain, -linearCeiling, linearCeiling);
+  return currentSample;
+}
+#endif
+
+//On monotonic deques
+/*
+A deque (double ended queue) may be added to or removed from at either
+end. Here, needed gains are added to the back and the deque is kept in
+increasing order: before adding a new gain, every gain at the back which
+is not lower is removed. Those gains can never be the minimum again; the
+new gain is lower and will stay in the window longer than they would.
+The front of the deque is therefore always the minimum of the window,
+and is removed once it is older than the window.
+
+Every gain is added once and removed at most once, so the cost per sample
+is constant on average, no matter how long the window is. This is the
+same result as the van Herk/Gil-Werman algorithm, which processes the
+window in fixed blocks instead.
+*/
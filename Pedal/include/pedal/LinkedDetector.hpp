@@ -0,0 +1,69 @@
+#ifndef LinkedDetector_hpp
+#define LinkedDetector_hpp
+
+#include <vector>
+#include "pedal/utilities.hpp"
+/*
+The shared half of linked multi-channel dynamics (Compressor and Gate
+processLinked(), see the notes at the bottom of Compressor.hpp). Each
+interleaved frame is reduced to one detector input, and the frames are
+delayed together so every channel gets the same gain at the same time.
+
+LinkedDetector linked(2);
+linked.process(input, output, bufferSize, delayInFrames, [&](float detected){
+  return gainFor(detected);//called once per frame, returns the scalar for it
+});
+*/
+class LinkedDetector{
+  public:
+  enum class Mode{
+    MAXIMUM,//detector follows the loudest channel
+    RMS//detector follows the RMS of all channels together
+  };
+  LinkedDetector(int numberOfChannels = 2, float maximumDelay = 100.0f);//(ms)
+  //for every frame, call gainForFrame(detected) and apply the scalar it returns
+  //to the frame 'delayInFrames' earlier. input and output may be the same
+  template<typename GainFunction>
+  void process(const float* input, float* output, int numberOfFrames, int delayInFrames,
+               GainFunction gainForFrame);
+  float detect(const float* frame);//one detector input for every channel
+
+  void setNumberOfChannels(int newNumberOfChannels);//allocates, clears the delay line
+  void setMode(Mode newMode);
+
+  int getNumberOfChannels();
+  Mode getMode();
+  int getMaximumDelayInFrames();
+
+  private:
+  int numberOfChannels;
+  Mode mode;
+  std::vector<float> delayLine;//interleaved, one frame of every channel per slot
+  int capacity;//in frames
+  int writeIndex;
+};
+
+template<typename GainFunction>
+void LinkedDetector::process(const float* input, float* output, int numberOfFrames, int delayInFrames,
+                             GainFunction gainForFrame){
+  delayInFrames = clamp(delayInFrames, 0, capacity - 1);
+  for(int i = 0; i < numberOfFrames; i++){
+    const float* inputFrame = input + i * numberOfChannels;
+    float* outputFrame = output + i * numberOfChannels;
+    float scalar = gainForFrame(detect(inputFrame));
+    //write before reading, so a delay of 0 passes the input straight through
+    float* writeFrame = &delayLine[writeIndex * numberOfChannels];
+    int readIndex = writeIndex - delayInFrames;
+    if(readIndex < 0){readIndex += capacity;}
+    const float* readFrame = &delayLine[readIndex * numberOfChannels];
+    for(int channel = 0; channel < numberOfChannels; channel++){
+      writeFrame[channel] = inputFrame[channel];
+    }
+    for(int channel = 0; channel < numberOfChannels; channel++){
+      outputFrame[channel] = readFrame[channel] * scalar;
+    }
+    writeIndex++;
+    if(writeIndex >= capacity){writeIndex = 0;}
+  }
+}
+#endif
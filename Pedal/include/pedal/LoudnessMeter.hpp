@@ -0,0 +1,100 @@
+#ifndef LoudnessMeter_hpp
+#define LoudnessMeter_hpp
+
+#include <vector>
+#include "pedal/Biquad.hpp"
+#include "pedal/utilities.hpp"
+/*
+Loudness meter following ITU-R BS.1770 (the measure used by EBU R128).
+Results are in LUFS (Loudness Units relative to Full Scale); one LU is
+one dB.
+
+RMS does not match how loud a signal sounds. The ear is less sensitive
+to low frequencies and a little more sensitive above ~2kHz, so every
+channel is first 'K-weighted' by two biquads: a high shelf (+4dB above
+~1.7kHz, the effect of the head) and a high-pass at ~38Hz (the revised
+low-frequency B curve, RLB). The weighted power of each channel is then
+multiplied by a channel weight (1.0 for front channels, 1.41 for
+surrounds, 0.0 for LFE) and summed.
+
+Power is collected in steps of 100ms:
+Momentary loudness - the last 400ms (4 steps)
+Short-term loudness - the last 3s (30 steps)
+Integrated loudness - the whole program since reset(), gated. Every
+400ms block (one each 100ms) quieter than -70 LUFS is ignored, then
+every block more than 10 LU below the level of the remaining blocks is
+ignored too; silence and pauses don't lower the result.
+
+The integrated gate needs every block since reset(). Rather than storing
+them, each block is counted in a histogram of 0.1 LU bins from -70 to
++10 LUFS, so memory stays the same no matter how long the program is.
+The result is accurate to within the bin size.
+
+True peak is the highest peak of the signal between samples, found by
+4x oversampling (see notes at bottom). Sample peaks can read several dB
+lower than the peaks a DAC will actually produce.
+
+Input is given as interleaved frames (one sample of every channel).
+*/
+class LoudnessMeter{
+  public:
+  LoudnessMeter(int numberOfChannels = 2);
+  void process(const float* frame);//one interleaved frame
+  void processBlock(const float* input, int numberOfFrames);//interleaved frames
+  void reset();//restart integration and true peak
+  void setNumberOfChannels(int newNumberOfChannels);//allocates, also resets
+  void setChannelWeight(int channel, float newWeight);//1.0 default
+
+  //-inf when there is nothing to measure yet
+  float getMomentaryLoudness();//LUFS, 400ms
+  float getShortTermLoudness();//LUFS, 3s
+  float getIntegratedLoudness();//LUFS, gated, since reset()
+  float getTruePeakDB(int channel);//dBTP, highest since reset()
+  float getTruePeakDB();//highest of every channel
+  float getChannelWeight(int channel);
+  int getNumberOfChannels();
+
+  private:
+  void setKWeighting();//calculate filters for the current sample rate
+  void finishStep();//called every 100ms
+  float powerToLUFS(double power);
+  float measureTruePeak(int channel, float input);
+  static const int stepsPerMomentary = 4;//400ms
+  static const int stepsPerShortTerm = 30;//3s
+  static const int histogramSize = 801;//-70 to +10 LUFS in 0.1 LU bins
+  static const int tapsPerPhase = 12;//true peak interpolation filter
+  int channels;
+  //K-weighting, one pair of filters per channel
+  std::vector<Biquad> shelfFilters;
+  std::vector<Biquad> highPassFilters;
+  float highPassScalar;//the standard high-pass is not normalized
+  std::vector<float> channelWeights;
+  //100ms steps
+  std::vector<double> stepTotals;//sum of squares of each channel in this step
+  int samplesPerStep;
+  int stepSampleCount;
+  double stepPowers[stepsPerShortTerm];//ring of the last 30 weighted step powers
+  int stepWriteIndex;
+  long stepsCompleted;
+  double momentaryPower;
+  double shortTermPower;
+  //integrated loudness
+  long histogram[histogramSize];
+  double binPowers[histogramSize];//power at the center of each bin
+  //true peak
+  float interpolationFilter[3][tapsPerPhase];//phases 1-3 (phase 0 is the sample itself)
+  std::vector<float> peakHistory;//2 * tapsPerPhase per channel, written twice
+  int peakWriteIndex;
+  std::vector<float> truePeaks;//linear
+};
+#endif
+
+//On true peak
+/*
+The highest sample is not always the highest point of the waveform;
+the analog signal rebuilt by a DAC may peak between two samples. To
+find those peaks, 3 new points are calculated between every pair of
+samples (4x oversampling), with a windowed sinc interpolation filter.
+The filter is split into 4 phases of 12 taps (a polyphase filter); the
+first phase is the original sample, so only 3 phases are calculated.
+*/
@@ -0,0 +1,54 @@
+#ifndef MappedBuffer_hpp
+#define MappedBuffer_hpp
+
+#include <vector>
+#include "utilities.hpp"
+#include "Interpolation.hpp"
+/*
+A read-only Buffer for sound files, loaded without copying.
+
+When a .wav file holds 32 bit float samples, the samples on disk are
+exactly the floats needed for playback. Instead of reading them into a
+new array, the file is 'memory mapped': the operating system makes the
+file appear in memory and loads each page from disk the first time it
+is touched. Loading is instant no matter how large the file is, and
+every program that maps the same file shares one copy of it in memory
+(the page cache).
+
+Any other format (16 or 24 bit, compressed...) can't be used directly;
+it is decoded into memory, as Buffer does. isMapped() tells which one
+happened. The read functions are the same as Buffer's either way.
+
+Memory mapping is used on POSIX systems (Linux, macOS); elsewhere files
+are always decoded.
+*/
+class MappedBuffer{
+  public:
+  MappedBuffer();
+  ~MappedBuffer();
+  MappedBuffer(const MappedBuffer&) = delete;//owns a mapping of the file
+  MappedBuffer& operator=(const MappedBuffer&) = delete;
+
+  bool loadSoundFile(const char* soundFilePath);//false if the file can't be read
+  void close();//unmap or free the samples
+
+  float getSample(float index, int channel = 0);//interpolated
+  float getSample(int index, int channel = 0);
+  const float* getContent();//interleaved samples
+  float getDuration();//(ms)
+  unsigned long getDurationInSamples();
+  int getNumberChannels();
+  unsigned getFileSampleRate();
+  bool isMapped();//true if the samples are read straight from the file
+
+  private:
+  bool mapFile(const char* soundFilePath, unsigned long long dataOffset);
+  const float* content;//points into the mapping or into decodedContent
+  std::vector<float> decodedContent;//used when the file can't be mapped
+  void* mapping;
+  unsigned long long mappingSize;
+  int numberChannels;
+  unsigned fileSampleRate;
+  unsigned long durationInSamples;
+};
+#endif
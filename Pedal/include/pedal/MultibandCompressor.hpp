@@ -0,0 +1,121 @@
+#ifndef MultibandCompressor_hpp
+#define MultibandCompressor_hpp
+
+#include <vector>
+#include "pedal/Biquad.hpp"
+#include "pedal/utilities.hpp"
+#include "pedal/FastMath.hpp"
+/*
+A multiband compressor divides the input into frequency bands and
+compresses each band separately. A loud bass note will no longer
+pull down the level of the cymbals.
+
+The bands are divided by Linkwitz-Riley crossovers (LR4). Each LR4
+filter is two identical Butterworth filters in a row (two biquads with
+Q = 0.7071). The low and high outputs of an LR4 crossover add back
+together with a flat magnitude; only the phase is changed, exactly
+like an all-pass filter at the crossover frequency.
+
+With more than two bands, the bands must have the same phase shift
+to add back together correctly. The input is split at the middle
+crossover, then each half is split again. The low half is passed
+through an all-pass at the high crossover and the high half through
+an all-pass at the low crossover, so every band has been through the
+same three phase shifts:
+
+input -> LR4(middle) -> low  -> all-pass(high) -> LR4(low)  -> band 0, band 1
+                     -> high -> all-pass(low)  -> LR4(high) -> band 2, band 3
+
+Each band has its own gain computer (threshold, ratio, attack, release,
+make-up gain). The four gain computers are calculated together in
+arrays of four, so the compiler may process all bands at once (SIMD).
+All bands share one look-ahead delay line; each slot of the delay line
+holds one sample of every band.
+*/
+class MultibandCompressor{
+  public:
+  static const int numberOfBands = 4;
+  MultibandCompressor(float maximumLookAheadTime = 10.0f);//(ms)
+  float process(float input);//main per-sample function
+  void processBlock(const float* input, float* output, int numberOfSamples);
+
+  void setCrossoverFrequency(int whichCrossover, float newFrequency);//0 to 2, (Hz)
+  void setThresholdDB(int whichBand, float newThresholdDB);
+  void setRatio(int whichBand, float newRatio);
+  void setAttackTime(int whichBand, float newAttackTime);//(ms)
+  void setReleaseTime(int whichBand, float newReleaseTime);//(ms)
+  void setMakeUpGainDB(int whichBand, float newMakeUpGainDB);
+  void setInputGainDB(float newInputGainDB);//applies to every band
+  void setAnalysisTime(float newAnalysisTime);//(ms) detector smoothing, every band
+  void setLookAheadTime(float newLookAheadTime);//(ms)
+
+  float getSample();
+  float getBandSample(int whichBand);//output of a single band (after compression)
+  float getLinearScalar(int whichBand);//gain currently applied to a band
+  float getCrossoverFrequency(int whichCrossover);
+  float getThresholdDB(int whichBand);
+  float getRatio(int whichBand);
+  float getAttackTime(int whichBand);
+  float getReleaseTime(int whichBand);
+  float getMakeUpGainDB(int whichBand);
+  float getInputGainDB();
+  float getAnalysisTime();
+  float getLookAheadTime();
+
+  private:
+  inline float processSample(float input);
+  void splitIntoBands(float input);//fills bandSample
+  void updateGains();//the gain computers, all bands at once
+  float calculateCoefficient(float timeInMS);
+  //crossover network. Each LR4 is two biquads per output
+  Biquad middleLowPass[2], middleHighPass[2];
+  Biquad lowLowPass[2], lowHighPass[2];
+  Biquad highLowPass[2], highHighPass[2];
+  Biquad lowAllPass, highAllPass;//phase compensation
+  float crossoverFrequencies[numberOfBands - 1];
+  //gain computers, one entry per band
+  float bandSample[numberOfBands];
+  float meanSquare[numberOfBands];//detector state
+  float gainDB[numberOfBands];//smoothed gain reduction (<= 0)
+  float linearGain[numberOfBands];//applied gain, including make-up
+  float thresholdDB[numberOfBands];
+  float ratio[numberOfBands];
+  float slope[numberOfBands];//derived from ratio: (1/ratio) - 1
+  float attackTime[numberOfBands];
+  float releaseTime[numberOfBands];
+  float attackCoefficient[numberOfBands];
+  float releaseCoefficient[numberOfBands];
+  float makeUpGainDB[numberOfBands];
+  float bandOutput[numberOfBands];
+  float linearInputGain;
+  float analysisTime;
+  float analysisCoefficient;
+  //shared look-ahead, one frame of 'numberOfBands' samples per slot
+  std::vector<float> delayLine;
+  int delayCapacity;//in frames
+  int delayWriteIndex;
+  int lookAheadInSamples;
+  float currentSample;
+};
+
+inline float MultibandCompressor::processSample(float input){
+  splitIntoBands(input * linearInputGain);
+  updateGains();
+  //store the new frame of bands, read the delayed frame back
+  float* writeFrame = &delayLine[delayWriteIndex * numberOfBands];
+  int readIndex = delayWriteIndex - lookAheadInSamples;
+  if(readIndex < 0){readIndex += delayCapacity;}
+  const float* readFrame = &delayLine[readIndex * numberOfBands];
+  for(int b = 0; b < numberOfBands; b++){
+    writeFrame[b] = bandSample[b];
+  }
+  currentSample = 0.0f;
+  for(int b = 0; b < numberOfBands; b++){
+    bandOutput[b] = readFrame[b] * linearGain[b];
+    currentSample += bandOutput[b];
+  }
+  delayWriteIndex++;
+  if(delayWriteIndex >= delayCapacity){delayWriteIndex = 0;}
+  return currentSample;
+}
+#endif
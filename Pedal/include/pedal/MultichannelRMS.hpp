@@ -0,0 +1,51 @@
+#ifndef MultichannelRMS_hpp
+#define MultichannelRMS_hpp
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+#include "utilities.hpp"
+#include "FastMath.hpp"
+/*
+The same sliding window RMS as BufferedRMS, for many channels at once
+(such as the meters of a mixing desk).
+
+Input is given as interleaved frames (one sample of every channel, then
+the next sample of every channel...). The history is stored the same way,
+so each step of the calculation is a simple loop over neighbouring
+channels which the compiler may process several channels at a time
+(SIMD). Nothing is calculated per channel that isn't needed: the square
+root and conversion to dB are only done when a level is requested.
+
+Like BufferedRMS, the running totals are doubles and are recomputed each
+time the write index wraps around so rounding errors never pile up.
+*/
+class MultichannelRMS{
+  public:
+  MultichannelRMS(int numberOfChannels = 2, int samplePeriod = 1024);
+  void process(const float* frame);//one interleaved frame
+  void processBlock(const float* input, int numberOfFrames);//interleaved frames
+  void setNumberOfChannels(int newNumberOfChannels);//allocates, clears history
+  void setSamplePeriod(int newSamplePeriod);//allocates, clears history
+
+  int getNumberOfChannels();
+  int getSamplePeriod();
+  float getMeanSquare(int channel);
+  float getRMS(int channel);
+  float getLevelDB(int channel);
+  void getMeanSquares(float* output);//every channel at once
+  void getRMS(float* output);
+  void getLevelsDB(float* output);
+
+  private:
+  void allocate();
+  void recalculateTotals();
+  int channels;
+  int samplesToAverage;
+  float periodReciprocal;
+  std::vector<float> squaredHistory;//interleaved, power of two number of frames
+  std::vector<double> runningTotals;//one per channel, double like BufferedRMS
+  int indexMask;
+  int writeIndex;//in frames
+};
+#endif
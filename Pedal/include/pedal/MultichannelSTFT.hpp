@@ -0,0 +1,72 @@
+#ifndef MultichannelSTFT_hpp
+#define MultichannelSTFT_hpp
+
+#include <vector>
+#include <memory>//std::unique_ptr
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include "pedal/STFT.hpp"
+/*
+An STFT for many channels at once. Each channel behaves exactly like
+its own STFT object (bins are accessed with getChannel()), but the
+expensive part, the FFT of every channel, is divided among a pool of
+worker threads.
+
+The FFTs of all channels happen on the same sample (every 'hopSize'
+samples). On that sample the work is handed to the workers, the audio
+thread helps with the work itself, and then waits for every channel to
+finish before continuing. No latency is added; every frame is complete
+before updateInput() returns, and every resynthesis is complete before
+updateOutput() overlap-adds it.
+
+Worker threads are started once, at construction. While waiting for
+work they sleep; while the audio thread waits on them it does not sleep
+(the wait is short, and sleeping may take longer than a whole buffer).
+With a single thread, everything happens on the calling thread.
+*/
+class MultichannelSTFT{
+  public:
+  //numberOfThreads includes the calling thread. 0 uses every hardware thread
+  MultichannelSTFT(int initialNumberOfChannels = 2, int initialWindowSize = 512,
+                   int initialOverlap = 4, int numberOfThreads = 0);
+  ~MultichannelSTFT();
+  bool updateInput(const float* inputFrame);//one sample per channel. true if frames are ready
+  bool isFFTReady();//are bins ready for manipulation?
+  void updateOutput(float* outputFrame);//write one sample per channel
+
+  STFT& getChannel(int whichChannel);//access the bins of a single channel
+  int getNumberOfChannels();
+  int getNumberOfThreads();
+  int getWindowSize();
+  int getOverlap();
+  int getHopSize();
+
+  private:
+  enum class Task{
+    ANALYSIS,//window and FFT the newest input frame
+    SYNTHESIS//inverse FFT and window into the output layers
+  };
+  void runTask(Task newTask);//divide the task among all threads and wait for it
+  void processChannels();//do the current task for channels until none remain
+  void workerLoop();//sleep, wake for a task, repeat
+  std::vector<std::unique_ptr<STFT>> channels;
+  std::vector<std::vector<float>> inputHistory;//per channel, see notes in cpp
+  int numberOfChannels;
+  int windowSize;
+  int hopSize;
+  int inputWritePosition;
+  int samplesUntilHop;
+  bool fftReadyFlag;
+  //worker pool
+  std::vector<std::thread> workers;
+  std::mutex taskMutex;
+  std::condition_variable taskAvailable;
+  unsigned taskGeneration;//incremented every time a new task is posted
+  bool shutdown;
+  Task currentTask;
+  std::atomic<int> nextChannel;//next channel to be claimed by a thread
+  std::atomic<int> channelsFinished;
+};
+#endif
@@ -0,0 +1,140 @@
+#ifndef Oversampler_hpp
+#define Oversampler_hpp
+
+#include <vector>
+#include "pdlSettings.hpp"
+#include "utilities.hpp"
+/*
+Runs part of a signal chain at 2, 4 or 8 times the sample rate.
+
+Nonlinear processing (waveshaping, saturation, the gain of a fast
+compressor) adds harmonics, and every harmonic above nyquist folds
+back down as aliasing. At a higher rate there is room above the audio
+band for those harmonics, and they are filtered out before the rate is
+lowered again. The same upsampled signal also shows the true peaks
+between samples (for a true peak limiter or meter).
+
+Each doubling is one half-band filter (see bottom), so 8x is three
+stages. Two kinds of filter:
+IIR (default) - polyphase allpass filters: a few multiplies per sample
+  and little latency, but the phase is not linear (like an analog
+  filter, high frequencies are delayed slightly more).
+LINEAR_PHASE - FIR filters, every frequency delayed by the same whole
+  number of samples, so a dry signal can be delayed to match exactly.
+  More latency and more multiplies, but the loops have no feedback and
+  the compiler can calculate several samples at once.
+Either keeps aliasing and images at least 75dB (LINEAR_PHASE) or 90dB
+(IIR) down, with the pass band flat to 90% of nyquist.
+
+Oversampler oversampler(4);
+oversampler.process(input, output, bufferSize, [](float* samples, int numberOfSamples){
+  for(int i = 0; i < numberOfSamples; i++){samples[i] = std::tanh(samples[i] * 4.0f);}
+});
+//or by hand, for a true peak:
+oversampler.upsample(input, upsampled, bufferSize);//upsampled holds bufferSize * 4
+*/
+class Oversampler{
+  public:
+  enum class Filter{
+    IIR,//allpass half-bands, low latency, phase not linear (default)
+    LINEAR_PHASE//FIR half-bands, constant whole sample latency
+  };
+  Oversampler(int factor = 2, Filter filter = Filter::IIR,
+              int maximumBlockSize = pdlSettings::bufferSize);//blocks are split above this
+  //input holds numberOfSamples, output holds numberOfSamples * factor
+  void upsample(const float* input, float* output, int numberOfSamples);
+  //input holds numberOfSamples * factor, output holds numberOfSamples
+  void downsample(const float* input, float* output, int numberOfSamples);
+  //upsample, call processor(samples, numberOfSamples * factor) to change the
+  //oversampled block in place, then downsample. input and output may be the same
+  template<typename Processor>
+  void process(const float* input, float* output, int numberOfSamples, Processor processor);
+  void reset();//clear all filter history
+
+  void setFactor(int newFactor);//1 (off), 2, 4 or 8, allocates
+  void setFilter(Filter newFilter);//allocates
+
+  int getFactor();
+  Filter getFilter();
+  int getMaximumBlockSize();
+  //of upsample() then downsample(), at the original rate. LINEAR_PHASE is exact,
+  //IIR is rounded from the delay of low frequencies
+  int getLatencyInSamples();
+  float getLatency();//the same, unrounded
+
+  private:
+  struct HalfBand{//one doubling
+    int blockSize;//largest input block at the lower rate
+    std::vector<float> between;//output at the higher rate, if there is another stage
+    //LINEAR_PHASE, 'halfOrder' is m in the notes at bottom
+    int halfOrder;
+    std::vector<float> taps;//every other tap, the first half (the center is 0.5)
+    std::vector<float> upInput;//history + block
+    std::vector<float> downEven, downOdd;//history + block, deinterleaved
+    std::vector<float> sum;//blockSize
+    //IIR
+    std::vector<float> coefficients;//first order allpass sections, alternating branches
+    std::vector<float> upState, downState;//last input and last output of each section
+  };
+  void design();//every stage for factor and filter
+  void designLinearPhase(HalfBand& band, float transition);
+  void designIIR(HalfBand& band, float transition);
+  void upsampleBlock(const float* input, float* output, int numberOfSamples);
+  void downsampleBlock(const float* input, float* output, int numberOfSamples);
+  void upsampleStage(HalfBand& band, const float* input, float* output, int numberOfSamples);
+  void downsampleStage(HalfBand& band, const float* input, float* output, int numberOfSamples);
+  static inline float allpass(float input, float coefficient, float* state){
+    //(input - last output) * coefficient + last input, arranged so only one
+    //multiply and one subtraction wait for the last output
+    float output = (input * coefficient + state[0]) - coefficient * state[1];
+    state[0] = input;
+    state[1] = output;
+    return output;
+  }
+  int factor;
+  int numberStages;
+  Filter filter;
+  int maximumBlockSize;
+  std::vector<HalfBand> stages;
+  std::vector<float> oversampled;//for process()
+  std::vector<float> padded;//LINEAR_PHASE, delay that makes the latency a whole sample
+  int padding;//at the highest rate
+  float latency;
+};
+
+template<typename Processor>
+void Oversampler::process(const float* input, float* output, int numberOfSamples, Processor processor){
+  for(int start = 0; start < numberOfSamples; start += maximumBlockSize){
+    int length = std::min(maximumBlockSize, numberOfSamples - start);
+    upsampleBlock(input + start, oversampled.data(), length);
+    processor(oversampled.data(), length * factor);
+    downsampleBlock(oversampled.data(), output + start, length);
+  }
+}
+#endif
+/*
+On half-band filters
+
+Doubling the rate puts a 0.0 between every two samples, which leaves an
+image of the spectrum mirrored above the old nyquist; lowering it keeps
+every other sample, which folds everything above the new nyquist down.
+Both need a low pass filter at a quarter of the higher rate, and a
+filter symmetrical about that point (a half-band filter) has two
+useful properties.
+
+LINEAR_PHASE: every other tap of a half-band FIR is 0.0, except the
+center, which is 0.5. Of each pair of output samples, one is only the
+center tap times an input sample (a copy, delayed), and the other is a
+filter with half the taps. With a length of 4m + 3, the delay up and
+back down is 2m + 1 samples at the lower rate.
+
+IIR: a half-band filter can be made from two allpass filters, a sample
+apart, averaged (Valenzuela and Constantinides; coefficients are
+designed as in Laurent de Soras' HIIR). At the lower rate each branch
+is a chain of first order allpass filters, so each output pair costs
+one multiply per section.
+
+After the first stage the signal is already band limited to the
+original nyquist, so the later stages can have a much wider transition
+and only need a few taps or sections.
+*/
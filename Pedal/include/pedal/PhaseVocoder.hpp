@@ -0,0 +1,82 @@
+#ifndef PhaseVocoder_hpp
+#define PhaseVocoder_hpp
+
+#include <vector>
+#include "pedal/STFT.hpp"
+#include "pedal/Buffer.hpp"
+/*
+A phase vocoder changes the pitch and/or duration of a sound
+independently. An STFT divides the sound into overlapping frames.
+For every bin of every frame, the difference in phase from the previous
+frame reveals the 'instantaneous frequency' of that bin; a sinusoid
+slightly above the bin's center frequency advances its phase slightly
+faster than expected. Knowing the true frequency of each bin allows:
+
+Pitch shifting: each bin is moved to a new bin (k * pitchRatio) and its
+frequency is scaled by the same ratio.
+
+Time stretching: frames are analyzed further apart (or closer together)
+than they are resynthesized. Each bin's phase is advanced by its true
+frequency over the synthesis hop, so the sinusoids stay continuous.
+
+Phase locking (Laroche & Dolson, 1999) keeps the bins surrounding a
+spectral peak locked to the peak's phase. This greatly reduces the
+'phasiness' or reverberant quality of a plain phase vocoder.
+
+Live input may be pitch shifted with processSample(). A Buffer may be
+pitch shifted and time stretched with generateSample() since the
+analysis position is free to move at its own rate.
+
+All frame data is allocated when the window size or overlap is set;
+processing does not allocate. The workload of an STFT is concentrated
+on the sample where the frame is analyzed (every 'hopSize' samples).
+*/
+class PhaseVocoder{
+  public:
+  PhaseVocoder(int initialWindowSize = 1024, int initialOverlap = 4);
+  float processSample(float input);//pitch shift live input
+  float generateSample();//pitch shift and/or time stretch the buffer reference
+
+  void setPitchRatio(float newPitchRatio);//2.0f is an octave up
+  void setTimeRatio(float newTimeRatio);//2.0f is twice as long (buffer only)
+  void setPhaseLocking(bool newPhaseLocking);
+  void setBuffer(Buffer* newBuffer);//source for generateSample()
+  void setPlayPosition(float newPositionInSamples);
+  void setWindowType(Window::Mode newWindowType);//not safe to call during processing
+  void setWindowSize(int powerOfTwoSize);//not safe to call during processing
+  void setOverlap(int newOverlap);//not safe to call during processing
+  float getPitchRatio();
+  float getTimeRatio();
+  bool getPhaseLocking();
+  float getPlayPosition();
+  int getWindowSize();
+  int getOverlap();
+  float getCurrentSample();
+
+  private:
+  void allocateFrames();//size all frame data to match the stft
+  void processFrame(int analysisHop);//modify the stft bins in place
+  void fillFrameFromBuffer(long startSample);
+  STFT stft;
+  Buffer* bufferReference;
+  float pitchRatio;
+  float timeRatio;
+  bool phaseLocking;
+  double playPosition;//analysis position within the buffer (in samples)
+  long previousFrameStart;//used to find the real analysis hop
+  int sampleCounter;//counts to 'hopSize' for generateSample()
+  float outputGain;//normalizes the overlap-add
+  float currentSample;
+  std::vector<float> analysisMagnitudes;
+  std::vector<float> analysisPhases;
+  std::vector<float> previousAnalysisPhases;
+  std::vector<float> binFrequencies;//true frequency in bins (may be fractional)
+  std::vector<float> synthesisMagnitudes;
+  std::vector<float> synthesisFrequencies;
+  std::vector<float> synthesisPhases;//accumulated phase of each output bin
+  std::vector<float> outputPhases;//synthesis phase after phase locking
+  std::vector<int> sourceBin;//which analysis bin each synthesis bin came from
+  std::vector<int> nearestPeak;//which peak owns each bin (phase locking)
+  std::vector<float> bufferFrame;//frame of samples read from the buffer
+};
+#endif
@@ -0,0 +1,85 @@
+#ifndef PlanarBuffer_hpp
+#define PlanarBuffer_hpp
+
+#include "utilities.hpp"
+/*
+A Buffer for processing code that works on whole blocks of a channel.
+
+Buffer stores channels interleaved (L R L R...), which suits playback of
+a frame at a time. Code that processes one channel at a time (filters,
+FFTs, SIMD loops) would rather read a channel as one unbroken array.
+PlanarBuffer stores each channel in its own array ('planar'), and every
+array starts on a 64 byte boundary (the size of a cache line, and more
+than the alignment of any SIMD register), so such code may load
+samples directly with aligned instructions.
+
+getChannel() returns a ChannelView, a pointer and a length (like
+std::span in C++20). It doesn't own the samples and is only valid until
+the buffer is resized or destroyed.
+
+for(float& sample : buffer.getChannel(1)){
+  sample *= 0.5f;
+}
+
+readBlock()/writeBlock() copy a range of samples, treating anything past
+either end as silence; getSample()/writeSample() check the index each
+time, the same as Buffer.
+*/
+class ChannelView{
+  public:
+  ChannelView(float* initialData = nullptr, unsigned long initialSize = 0)
+    : samples(initialData), length(initialSize){}
+  float* data() const {return samples;}
+  unsigned long size() const {return length;}
+  bool empty() const {return length == 0;}
+  float& operator[](unsigned long index) const {return samples[index];}//unchecked
+  float* begin() const {return samples;}
+  float* end() const {return samples + length;}
+
+  private:
+  float* samples;
+  unsigned long length;
+};
+
+class PlanarBuffer{
+  public:
+  static const int alignment = 64;//(bytes) every channel starts on this boundary
+  PlanarBuffer(int numberOfChannels = 1, float initialDuration = 1000.0f);
+  PlanarBuffer(const PlanarBuffer& other);
+  PlanarBuffer(PlanarBuffer&& other) noexcept;
+  PlanarBuffer& operator=(const PlanarBuffer& other);
+  PlanarBuffer& operator=(PlanarBuffer&& other) noexcept;
+  ~PlanarBuffer();
+
+  //size, all samples are silent after any of these
+  void setDuration(float newDuration);//(ms)
+  void setDurationInSamples(unsigned long newDurationInSamples);
+  void setNumberChannels(int newNumberOfChannels);
+  void clear();//silence, size unchanged
+
+  ChannelView getChannel(int channel);
+  float* getChannelPointer(int channel);//aligned to 'alignment'
+  //copy a range, samples outside the buffer read as 0.0f (and are not written)
+  void readBlock(int channel, long start, float* output, int numberOfSamples);
+  void writeBlock(int channel, long start, const float* input, int numberOfSamples);
+  void addBlock(int channel, long start, const float* input, int numberOfSamples);
+  //conversion to and from interleaved frames (such as Buffer or an audio callback)
+  void readInterleaved(long start, float* output, int numberOfFrames);
+  void writeInterleaved(long start, const float* input, int numberOfFrames);
+
+  void writeSample(float inputSample, long index, int channel = 0);//index is clamped
+  float getSample(long index, int channel = 0);//index is clamped
+  float getDuration();//(ms)
+  unsigned long getDurationInSamples();
+  int getNumberChannels();
+
+  private:
+  void allocate();//for the current size, silent
+  void release();
+  float* storage;//as allocated, may not be aligned
+  float* alignedStorage;//first channel starts here
+  unsigned long channelStride;//samples from one channel to the next (padded for alignment)
+  unsigned long durationInSamples;
+  int numberChannels;
+};
+#endif
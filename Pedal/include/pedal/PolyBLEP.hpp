@@ -0,0 +1,199 @@
+#ifndef PolyBLEP_hpp
+#define PolyBLEP_hpp
+
+#include <cmath>
+#include <vector>
+#include "pdlSettings.hpp"
+#include "utilities.hpp"
+/*
+Saw, pulse and triangle oscillators with very little aliasing, and no
+tables (unlike WTSaw, WTSquare and WTTriangle).
+
+The trivial waveforms (see TSaw, TSquare) jump, or turn a corner,
+between two samples, and everything above nyquist in that jump folds
+back down as aliasing. A polyBLEP (band limited step) smooths each jump
+over the samples either side of it with a short polynomial, and a
+polyBLAMP (band limited ramp, the step integrated) does the same for
+each corner. Both only need to know how close the phase is to the
+discontinuity, so they cost a few multiplies per sample and can be
+used at any frequency, changing every sample.
+
+PULSE has a pulse width (0.0 to 1.0, 0.5 is a square) that can be
+modulated smoothly (PWM). setSyncFrequency() hard syncs the oscillator
+to an internal master: each time the master starts a cycle, so does
+this oscillator, and the jump that makes is smoothed too (see bottom).
+
+PolyBLEP saw(110.0f);
+saw.setSyncFrequency(55.0f);//hard sync, sweep saw's frequency for the classic sound
+saw.generateBlock(output, bufferSize);
+*/
+class PolyBLEP{
+  public:
+  enum class Waveform{
+    SAW,//rising, -1.0 to 1.0
+    PULSE,//1.0 for the first 'pulse width' of each cycle, -1.0 after
+    TRIANGLE//starts at 0.0, rising
+  };
+  PolyBLEP();
+  PolyBLEP(float frequency);
+  ~PolyBLEP();
+  float generateSample();
+  float* generateBlock();
+  void generateBlock(float* output, int numberOfSamples);
+  //with a frequency for every sample (FM, or any other modulation)
+  void generateBlock(float* output, const float* frequencies, int numberOfSamples);
+
+  //"setters"
+  void setWaveform(Waveform newWaveform);
+  void setFrequency(float newFrequency);//cheap enough to call every sample
+  void setPhase(float newPhase);//(radians)
+  void setAmplitude(float newAmplitude);
+  void setPulseWidth(float newPulseWidth);//0.0 to 1.0, PULSE only
+  void setSyncFrequency(float newSyncFrequency);//of the master, 0.0 turns sync off
+
+  //"getters"
+  Waveform getWaveform();
+  float getFrequency();
+  float getPhase();//(radians)
+  float getAmplitude();
+  float getPulseWidth();
+  float getSyncFrequency();
+  float getSample();
+  float* getBlock();
+
+  //the corrections themselves, shared with PolyBLEPBank. 'phase' is 0.0 to 1.0, and
+  //the discontinuity is at 0.0 (and 1.0). Subtract blep() once for every 2.0 a
+  //waveform falls there, add blamp() once for every 1.0 per sample its slope rises.
+  //There are no comparisons (the compiler won't vectorize them), only truncation,
+  //fabs and copysign
+  static inline float blep(float phase, float inverseIncrement){
+    float nearness = closeness(phase, inverseIncrement);
+    //negative from the discontinuity on (0.0 included), positive before it
+    return std::copysign(nearness * nearness, -(phase - static_cast<int>(phase + 0.5f)));
+  }
+  static inline float blamp(float phase, float inverseIncrement){
+    float nearness = closeness(phase, inverseIncrement);
+    return nearness * nearness * nearness * (1.0f / 6.0f);
+  }
+  //1.0 at the discontinuity, falling to 0.0 a sample either side
+  static inline float closeness(float phase, float inverseIncrement){
+    float distance = (phase - static_cast<int>(phase + 0.5f)) * inverseIncrement;//in samples
+    float nearness = 1.0f - std::fabs(distance);
+    return 0.5f * (nearness + std::fabs(nearness));//or 0.0 if negative
+  }
+  static inline float inverse(float increment){//for shape()
+    return 1.0f / std::max(std::fabs(increment), 1.0e-9f);
+  }
+  static inline float wrap(float phase){//-1.0 to 2.0, back to 0.0 to 1.0
+    return phase - static_cast<float>(static_cast<int>(phase + 1.0f) - 1);
+  }
+  //a whole block at a steady frequency, in loops the compiler can vectorize.
+  //phase and increment are double so long blocks don't drift
+  template<Waveform shapeToRender, bool accumulate>
+  static void renderSteady(float* output, int numberOfSamples, double phase, double increment,
+                           float pulseWidth, float amplitude);
+  //one sample of a waveform, at 'phase' (0.0 to 1.0), moving 'increment' per sample
+  template<Waveform shapeToRender>
+  static inline float shape(float phase, float increment, float inverseIncrement, float pulseWidth){
+    switch(shapeToRender){
+      case Waveform::SAW:
+        return 2.0f * phase - 1.0f - blep(phase, inverseIncrement);
+      case Waveform::PULSE:{
+        float fallPhase = wrap(phase - pulseWidth);
+        //1.0 before the pulse width, -1.0 from it on
+        return -std::copysign(1.0f, phase - pulseWidth) +
+               blep(phase, inverseIncrement) - blep(fallPhase, inverseIncrement);
+      }
+      case Waveform::TRIANGLE:{
+        //a quarter cycle on, so the corners are at 0.0 (bottom) and 0.5 (top)
+        float cornerPhase = wrap(phase + 0.25f);
+        float topPhase = wrap(cornerPhase + 0.5f);
+        //the slope changes by 8.0 per cycle at each corner
+        float slopeChange = 8.0f * std::fabs(increment);
+        return 1.0f - 4.0f * std::fabs(cornerPhase - 0.5f) +
+               slopeChange * (blamp(cornerPhase, inverseIncrement) - blamp(topPhase, inverseIncrement));
+      }
+    }
+    return 0.0f;
+  }
+
+  private:
+  template<Waveform shapeToRender>
+  void renderWaveform(float* output, const float* frequencies, int numberOfSamples);
+  template<Waveform shapeToRender, bool synced>
+  void renderBlock(float* output, const float* frequencies, int numberOfSamples);
+  template<Waveform shapeToRender>
+  float nextSample(double increment);
+  template<Waveform shapeToRender>
+  float nextSyncedSample(double increment);
+  template<Waveform shapeToRender>
+  inline float trivial(float atPhase);//the waveform without corrections
+  template<Waveform shapeToRender>
+  inline float slope(float atPhase);//per cycle
+  inline float singlePrecision(double atPhase);//phase as a float, still below 1.0
+  //a discontinuity 'fraction' of the way to the next sample, smoothed over this
+  //sample ('sample') and the next ('nextCorrection')
+  inline void smooth(float fraction, float step, float slopeChange, float& sample);
+  Waveform waveform;
+  float frequency, amplitude, pulseWidth;
+  double phase, phaseIncrement;//cycles
+  float syncFrequency;
+  double syncPhase, syncIncrement;
+  float nextCorrection;//the half of a sync discontinuity after it
+  float currentSample;
+  float* currentBlock = nullptr;
+};
+
+/*
+The same oscillators for many voices at once (unison stacks, or the
+oscillators of a polyphonic synth), all with the same waveform but
+each with its own frequency, pulse width and amplitude, changed
+between blocks. Each voice is a whole block in one loop, with phases
+multiplied out rather than summed, so the compiler can calculate
+several samples at once. No sync.
+
+PolyBLEPBank unison(7);
+for(int i = 0; i < 7; i++){unison.setFrequency(i, 110.0f * std::pow(2.0f, (i - 3) * 0.01f));}
+unison.render(output, bufferSize);//every voice mixed, output is replaced
+*/
+class PolyBLEPBank{
+  public:
+  PolyBLEPBank(int numberVoices = 8);
+  void render(float* output, int numberOfSamples);//mixed, output is replaced
+  void render(float** outputs, int numberOfSamples);//one output per voice, replaced
+
+  void setWaveform(PolyBLEP::Waveform newWaveform);
+  void setFrequency(int voice, float newFrequency);
+  void setPhase(int voice, float newPhase);//(radians)
+  void setAmplitude(int voice, float newAmplitude);
+  void setPulseWidth(int voice, float newPulseWidth);
+
+  PolyBLEP::Waveform getWaveform();
+  int getNumberVoices();
+  float getFrequency(int voice);
+  float getAmplitude(int voice);
+  float getPulseWidth(int voice);
+
+  private:
+  template<PolyBLEP::Waveform shapeToRender, bool mix>
+  void renderVoices(float** outputs, int numberOfSamples);
+  PolyBLEP::Waveform waveform;
+  int numberVoices;
+  //one array per property. Phases and increments are double, like PolyBLEP's
+  std::vector<double> phase, increment;
+  std::vector<float> pulseWidth, amplitude;
+};
+#endif
+/*
+On hard sync
+
+When the master starts a cycle between two samples, this oscillator
+jumps from wherever it was to the start of its own cycle, and that jump
+needs smoothing like any other. But the polyBLEP for a jump changes the
+sample before it as well as the one after, and a jump caused by another
+oscillator can't be seen coming from this one's phase. So the master is
+kept inside, where its phase is known a sample ahead: in sync mode each
+sample looks for every discontinuity before the next one (its own wraps
+and edges, then the sync), adds the first half of each to this sample
+and keeps the second half for the next.
+*/
@@ -0,0 +1,78 @@
+#ifndef Recorder_hpp
+#define Recorder_hpp
+
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "utilities.hpp"
+#include "../../external/dr_wav.h"//for writing .wav
+/*
+Records audio to a sound file while it plays, for as long as needed.
+
+Writing to disk may take any amount of time, which the audio thread
+can't wait for. Instead the audio thread copies each block into a ring
+buffer (the same lock-free scheme as DiskBuffer, in reverse) and a
+writer thread converts the samples and writes them to the file.
+
+If the disk can't keep up and the ring buffer fills, frames that don't
+fit are dropped rather than waiting. getOverflowCount() reports how many
+were lost; a larger buffer time helps.
+
+Files may be .wav (up to 4GB) or .w64 (Sony Wave64, no size limit, for
+long multitrack sessions), with 16 bit, 24 bit or 32 bit float samples.
+
+Recorder recorder(8);//8 channels
+recorder.start("session.w64", Recorder::SampleFormat::FLOAT_32, Recorder::Container::W64);
+...
+recorder.pushFrames(output, bufferSize);//in the audio callback
+...
+recorder.stop();//finishes the file
+*/
+class Recorder{
+  public:
+  enum class SampleFormat{
+    PCM_16,
+    PCM_24,
+    FLOAT_32
+  };
+  enum class Container{
+    WAV,
+    W64
+  };
+  Recorder(int numberOfChannels = 2, float bufferTime = 2000.0f);//(ms) size of the ring buffer
+  ~Recorder();//stops recording
+  Recorder(const Recorder&) = delete;//owns a thread and an open file
+  Recorder& operator=(const Recorder&) = delete;
+
+  //control thread functions
+  bool start(const char* soundFilePath, SampleFormat format = SampleFormat::PCM_24,
+             Container container = Container::WAV);//false if the file can't be created
+  void stop();//write whatever is left and close the file (safe while pushFrames() runs)
+  //audio thread function, never blocks. Returns frames accepted
+  int pushFrames(const float* input, int numberOfFrames);//interleaved
+
+  bool isRecording();
+  int getNumberChannels();
+  unsigned long getOverflowCount();//frames dropped so far
+  unsigned long getFramesWritten();//frames written to the file so far
+
+  private:
+  void writeLoop();//writer thread main loop
+  int writeAvailable();//write what is in the ring, returns frames written
+  int capacity;//ring size in frames (power of two)
+  int indexMask;
+  std::vector<float> ring;//interleaved
+  std::vector<unsigned char> encoded;//samples converted to the file format
+  std::atomic<unsigned long long> writeIndex;//audio thread
+  std::atomic<unsigned long long> readIndex;//writer thread
+  std::atomic<bool> running;
+  std::atomic<bool> recording;
+  std::atomic<int> pushing;//pushFrames() calls in progress, stop() waits for them
+  std::atomic<unsigned long> overflowCount;
+  std::atomic<unsigned long> framesWritten;
+  std::thread writerThread;
+  drwav wav;
+  SampleFormat sampleFormat;
+  int numberChannels;
+};
+#endif
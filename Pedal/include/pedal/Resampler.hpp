@@ -0,0 +1,53 @@
+#ifndef Resampler_hpp
+#define Resampler_hpp
+
+#include <vector>
+#include "utilities.hpp"
+/*
+Converts audio from one sample rate to another, such as a 44.1kHz sound
+file that will be played at 48kHz. Without conversion the file would
+play too fast (and too high in pitch).
+
+Each output sample lies somewhere between two input samples. Its value
+is found with a windowed sinc filter centered on that point, the best
+possible interpolation for a band limited signal. Frequencies that can't
+exist at the new rate are removed by the same filter.
+
+Calculating a new filter for every output sample would be slow. The
+ratio between two common rates is a fraction (48000/44100 = 160/147),
+so the output positions only ever fall on 160 different points between
+input samples. A filter is calculated once for each of these points
+('phases'), and each output sample uses the phase it lands on. This is
+a polyphase resampler. Unusual ratios are limited to 4096 phases (the
+phase just before the output point is used).
+
+The whole signal is converted at once (such as when loading a file).
+The work is divided into chunks of every channel and shared between
+threads.
+*/
+class Resampler{
+  public:
+  Resampler(unsigned inputRate, unsigned outputRate, int tapsPerPhase = 64);//more taps, steeper filter
+  unsigned long getOutputLength(unsigned long inputLength);//in frames
+  //interleaved input and output. output must hold getOutputLength(inputFrames) frames.
+  //numberOfThreads includes the calling thread. 0 uses every hardware thread
+  void process(const float* input, unsigned long inputFrames, float* output,
+               int numberOfChannels = 1, int numberOfThreads = 0);
+  unsigned getInputRate();
+  unsigned getOutputRate();
+  //one phase of a kaiser windowed sinc, normalised to unity gain. The taps are centered
+  //between input samples taps/2 - 1 and taps/2, 'fraction' of the way from one to the next.
+  //cutoff is a fraction of the sample rate (0.5 is nyquist)
+  static void windowedSinc(float* coefficients, int taps, double cutoff, double fraction);
+
+  private:
+  void designFilter();
+  void processChunk(const float* channelInput, unsigned long inputFrames, float* output,
+                    int numberOfChannels, int channel, unsigned long start, unsigned long end);
+  unsigned inputRate, outputRate;
+  unsigned long long upFactor, downFactor;//outputRate/inputRate as a reduced fraction
+  int numberOfPhases;
+  int taps;//per phase
+  std::vector<float> filter;//numberOfPhases * taps
+};
+#endif
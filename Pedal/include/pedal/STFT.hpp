@@ -10,8 +10,9 @@ windowed overlap+add FFT
 #include <vector>//for dynamic arrays
 #include <cmath>
 
-#include "pedal/Window.hpp"
+#include "pedal/WindowTable.hpp"
 #include "pedal/MicroBenchmark.hpp"
+#include "pedal/FastMath.hpp"
 /*
 STFT, or Short-Time Fourier Transform, converts
 an incoming signal from time domain to frequency
@@ -21,7 +22,9 @@ class STFT{
   public:
   STFT(int initialWindowSize = 512, int initialOverlap = 4);
   bool updateInput(float input);//return true if full frame is ready
+  bool analyzeFrame(const float* frame);//analyze 'windowSize' samples in place of updateInput
   bool isFFTReady();//are bins ready for manipulation?
+  void synthesizeFrame();//iFFT the ready frame (called by updateOutput if needed)
   float updateOutput();//update system
   
   void setWindowType(Window::Mode newWindowType);//not safe to call during analysis
@@ -36,16 +39,23 @@ class STFT{
   int getOverlap();
   int getHopSize();//windowSize / overlap
   int getNumberOfBins();//windowSize / 2
+  float getOverlapAddGain();//gain of windowed analysis + windowed resynthesis
   std::complex<float> getBin(int whichBin);//get fft output at whichBin
   float getBinMagnitude(int whichBin);// get bin magnitude, calculated at tall
   float getBinPhase(int whichBin); //get bin phase, calculated at call
   float getBinFrequency(int whichBin);//get bin frequency, calculated at call
   float* getRealBufferPointer();// get pointer to real array (size windowSize)
   float* getImaginaryBufferPointer();// get pointer to imaginary array (size windowSize)
+  //whole-frame operations. These work on all (windowSize/2)+1 bins at once and
+  //are much cheaper than calling the per-bin functions in a loop
+  void computeMagnitudes(float* magnitudeOutput);//fill array of size getNumberOfBins()+1
+  void computePhases(float* phaseOutput);//fill array of size getNumberOfBins()+1
+  void setFromPolar(const float* magnitudes, const float* phases);//replace every bin
+  void multiplySpectrum(const STFT& other);//complex multiply bins (convolution)
 
   private:
   float currentSample;
-  void calculateWindow();//generate stored window data
+  void calculateWindow();//find the shared window for the current type and size
   inline void calculateWindowedInput(const int inputOffset);
   int hopSize;//how many new samples before next analysis?
   int overlap;//how many analyses in the span of one window
@@ -60,10 +70,14 @@ class STFT{
   std::vector<float> windowedInputSegment;//FFT input
   std::vector<float> realBuffer;//real results of FFT
   std::vector<float> imaginaryBuffer;//imaginary results of FFT
-  std::vector<float> window;//store window locally
+  std::shared_ptr<const WindowTable> windowTable;//shared with every STFT of the same type and size
+  const float* window;//windowTable's data
   std::vector<std::vector<float>> windowedOutput;//updated every 'hopSize' samples
   int currentOutputIndex;//which sample in the overlapAddOutput buffer
-  audiofft::AudioFFT fft;//fast fourier transform (from external audioFFT library)
+  int outputAlignment;//position within a hop where the latest frame was written
+  //fast fourier transform (from external audioFFT library). Its twiddle tables
+  //are cached by size and shared by every STFT; only scratch memory is per instance
+  audiofft::AudioFFT fft;
 };
 
 inline void STFT::calculateWindowedInput(const int inputOffset){
@@ -0,0 +1,61 @@
+#ifndef SamplePool_hpp
+#define SamplePool_hpp
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "Buffer.hpp"
+/*
+Loads each sound file once and shares it between every player that
+uses it.
+
+A sampler instrument may use the same file in hundreds of zones. Giving
+each zone its own Buffer would load (and store) the file hundreds of
+times. Instead, load() returns a Sample: a shared, read only handle to
+the one Buffer holding that file. Asking for the same path again
+returns another handle to the same Buffer. BufferPlayer accepts a
+Sample directly, and the Buffer lives for as long as any handle does.
+
+Freeing memory can take a long time, so it should never happen on the
+audio thread. The pool always holds a handle of its own, so a player
+letting go of a Sample never frees it. A sample is only freed by
+collect() (on the control thread), once it has been released from the
+pool and no player is still using it.
+
+SamplePool pool;
+SamplePool::Sample kick = pool.load("kick.wav");
+BufferPlayer zoneA(kick);
+BufferPlayer zoneB(kick);//same memory as zoneA
+...
+pool.release("kick.wav");//no longer needed
+pool.collect();//frees it, once zoneA and zoneB stop using it
+
+Every function here is for the control thread, and may lock.
+*/
+class SamplePool{
+  public:
+  typedef std::shared_ptr<const Buffer> Sample;
+  SamplePool();
+  ~SamplePool();//handles still held elsewhere remain valid
+  SamplePool(const SamplePool&) = delete;
+  SamplePool& operator=(const SamplePool&) = delete;
+
+  Sample load(const char* soundFilePath);//loads the file only if needed, nullptr on failure
+  Sample find(const char* soundFilePath);//nullptr if not loaded
+  void release(const char* soundFilePath);//forget this path, freed by collect() when unused
+  void releaseUnused();//release every sample no player is using
+  int collect();//free released samples that are no longer used, returns how many
+
+  int getNumberSamples();//loaded and not released
+  int getNumberReleased();//released, but still in use
+  unsigned long getMemoryUsage();//(bytes) sample data held, including released samples
+
+  private:
+  static unsigned long bytesUsed(const Sample& sample);
+  std::mutex poolLock;
+  std::map<std::string, Sample> samples;//by path
+  std::vector<Sample> released;//waiting for the last player to let go
+};
+#endif
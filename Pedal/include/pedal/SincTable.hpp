@@ -0,0 +1,54 @@
+#ifndef SincTable_hpp
+#define SincTable_hpp
+
+#include <vector>
+#include "utilities.hpp"
+/*
+Windowed sinc filters for interpolating between samples at any position
+(see BufferPlayer's SINC mode).
+
+Played faster than normal, a sample's frequencies rise, and those that
+end up above nyquist alias. Before reading, those frequencies have to
+be removed, and the faster the playback, the lower the filter's cutoff
+must be. A lower cutoff needs a longer filter.
+
+The table holds one filter for each half octave of speed (1x to 8x),
+and each filter is calculated at 'phases' positions between two
+samples. A position between phases is found by mixing the two nearest.
+It is calculated once, when first used, and shared by every player.
+
+const SincTable& table = SincTable::get();
+int level = table.getLevel(speed);
+table.getWeights(level, position, weights);//position is 0.0 to 1.0
+float sample = dotProduct(weights, &input[index - table.getTaps(level) / 2 + 1], table.getTaps(level));
+*/
+class SincTable{
+  public:
+  static const int levels = 7;//half octaves, up to 8x speed
+  static const int phases = 128;//between two neighbouring samples
+  static const int maximumTaps = 256;
+  static const SincTable& get();//built on first use (not on the audio thread, ideally)
+  int getLevel(float speed) const;//shortest filter that removes everything that would alias
+  int getTaps(int level) const;//multiple of 8
+  //weights for a point 'position' (0.0 to 1.0) past sample taps/2 - 1, into 'weights'
+  void getWeights(int level, float position, float* weights) const;
+
+  private:
+  SincTable();
+  int taps[levels];
+  std::vector<float> filters[levels];//(phases + 1) * taps, the last phase is a whole sample on
+};
+
+//sum of a[i] * b[i]. Eight independent sums, which the compiler keeps in SIMD registers
+inline float dotProduct(const float* a, const float* b, int length){
+  float sums[8] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+  int i = 0;
+  for(; i + 8 <= length; i += 8){
+    for(int lane = 0; lane < 8; lane++){
+      sums[lane] += a[i + lane] * b[i + lane];
+    }
+  }
+  for(; i < length; i++){sums[0] += a[i] * b[i];}
+  return ((sums[0] + sums[4]) + (sums[1] + sums[5])) + ((sums[2] + sums[6]) + (sums[3] + sums[7]));
+}
+#endif
@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include "utilities.hpp"
+#include "FastMath.hpp"
 
 class StreamedRMS{
   public:
@@ -26,7 +27,8 @@ inline float StreamedRMS::process(float input){
   if(sampleCounter == 0){//if the sampleCounter reached max
     //calculate the average value over those N samples
     if(runningTotal>0.0f){
-      float dB = 20.0f * std::log10(sqrt(runningTotal*periodReciprocal));
+      //20*log10(sqrt(x)) is 10*log10(x); no need for the sqrt
+      float dB = fastPowerToDB(runningTotal*periodReciprocal);
       smoothOutput.setTarget(dB);
     }else{
       smoothOutput.setTarget(0.0f);
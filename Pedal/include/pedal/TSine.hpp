@@ -3,26 +3,36 @@
 
 #include <cmath> //so we can use sin()
 #include "pdlSettings.hpp"//so we can access sampleRate and bufferSize
+#include "FastMath.hpp"//polynomial sine
 
 class TSine {//Pedal Trivial Sine Oscillator
   public://everything listed after this is public
+  enum class Mode{
+    POLYNOMIAL,//sine of the phase, any frequency (default)
+    QUADRATURE//a rotating phasor, cheapest for a fixed frequency (see bottom)
+  };
   TSine();//constructor, defined in the cpp
   TSine(float frequency);//option to set frequency on construction
   ~TSine();//deconstructor (may be needed to free memory)
   float generateSample();//generate and return a single sample
   float* generateBlock();//generate and return a block of samples
+  void generateBlock(float* output, int numberOfSamples);//into any array, such as one of many partials
 
   //"setters"
   void setFrequency(float newFrequency);
-  void setPhase(float newPhase);
+  void setPhase(float newPhase);//(radians)
   void setAmplitude(float newAmplitude);
+  void setMode(Mode newMode);
+  void setAccuracy(SineAccuracy newAccuracy);//POLYNOMIAL mode only
 
   //"getters"
   float getFrequency();
-  float getPhase();
+  float getPhase();//(radians)
   float getAmplitude();
   float getSample();
   float* getBlock();
+  Mode getMode();
+  SineAccuracy getAccuracy();
     
   private://everything after this is private (cannot be accessed externally without
   //a "getter" or a "setter"
@@ -31,15 +41,54 @@ class TSine {//Pedal Trivial Sine Oscillator
   inline float generateNextSample(){//return a float even if you don't use it
     //inline functions must be located in the header file, so 
     //we will define it here. 
-    currentSample = std::sin(phase) * amplitude;//calculate single sample
-    phase += (float)phaseIncrement;//increment phase for the next sample
-    phase = fmod(phase, 6.283185307179586f);
+    if(mode == Mode::QUADRATURE){
+      currentSample = static_cast<float>(sine) * amplitude;
+      rotate();
+      if(++samplesSinceNormalized >= 64){normalize();}
+      return currentSample;
+    }
+    currentSample = sineOfPhase(static_cast<float>(phase)) * amplitude;//calculate single sample
+    phase += phaseIncrement;//increment phase for the next sample
+    phase -= phase >= 1.0 ? 1.0 : 0.0;//wrap, without fmod()
+    phase += phase < 0.0 ? 1.0 : 0.0;//negative frequencies
     return currentSample;
   }
+  inline float sineOfPhase(float cycles){
+    switch(accuracy){//the same every sample, so well predicted
+      case SineAccuracy::LOW: return fastSinCycles<SineAccuracy::LOW>(cycles);
+      case SineAccuracy::MEDIUM: return fastSinCycles<SineAccuracy::MEDIUM>(cycles);
+      default: return fastSinCycles<SineAccuracy::HIGH>(cycles);
+    }
+  }
+  inline void rotate(){//advance the phasor by one sample
+    double nextCosine = cosine * rotationCosine - sine * rotationSine;
+    sine = cosine * rotationSine + sine * rotationCosine;
+    cosine = nextCosine;
+  }
+  void normalize();//pull the phasor back to a length of 1.0
+  void updatePhaseFromPhasor();
 
-  float frequency, phase, amplitude;//standard oscillator variables
+  float frequency, amplitude;//standard oscillator variables
+  double phase;//in cycles, 0.0 to 1.0
   float currentSample;//current working sample
   float* currentBlock = nullptr;//current working block of samples
-  double phaseIncrement;//extra precision necessary 
+  double phaseIncrement;//extra precision necessary (cycles per sample)
+  Mode mode;
+  SineAccuracy accuracy;
+  //QUADRATURE mode
+  double sine, cosine;//the phasor (double, so the frequency is exact to far below hearing)
+  double rotationSine, rotationCosine;//one sample of rotation
+  int samplesSinceNormalized;
 };
 #endif 
+
+//On QUADRATURE mode
+/*
+A point on a circle, rotated by the same angle every sample, traces out
+a sine (its height) and a cosine (its distance across). Rotating is four
+multiplies and two adds, with no sine to calculate at all. Rounding
+slowly changes the length of the phasor, so it is corrected every 64
+samples (and every block). Changing the frequency is more expensive
+than in POLYNOMIAL mode, so it suits oscillators held at one frequency,
+such as additive partials or test tones.
+*/
@@ -0,0 +1,134 @@
+#ifndef Waveshaper_hpp
+#define Waveshaper_hpp
+
+#include <vector>
+#include "pdlSettings.hpp"
+#include "utilities.hpp"
+#include "Oversampler.hpp"
+/*
+Distortion by waveshaping: every sample is passed through a transfer
+curve, after a drive gain. Louder input is pushed further into the
+curve's bend, and the curve adds harmonics.
+
+The curve (a preset, or any function with setCustomCurve()) is
+calculated once into a table from -8.0 to 8.0, so processing costs a
+lookup and a few multiplies per sample rather than a call to
+std::tanh. Past the ends of the table the curve stays at its end
+values.
+
+The harmonics reach past nyquist and alias, which is what makes plain
+digital distortion sound harsh. Two remedies, which work well together:
+ADAA mode (antiderivative antialiasing, see bottom) removes most of the
+aliasing for half a sample of latency and a second lookup, and
+setOversampling() runs the curve at 2, 4 or 8 times the sample rate
+(see Oversampler).
+
+Waveshaper drive(Waveshaper::Curve::TUBE);
+drive.setDriveDB(18.0f);
+drive.setOutputGainDB(-12.0f);
+drive.setOversampling(2);
+drive.processBlock(input, output, bufferSize);//input and output may be the same
+*/
+class Waveshaper{
+  public:
+  enum class Curve{
+    TANH,//smooth, symmetrical (default)
+    SOFT_CLIP,//cubic, flat from +-1.0 on
+    HARD_CLIP,//straight to +-1.0, then flat
+    TUBE,//tanh off center, positive input saturates sooner (even harmonics, some DC)
+    CUSTOM//see setCustomCurve()
+  };
+  enum class Mode{
+    TABLE,//the curve, interpolated (default)
+    ADAA//the curve's antiderivative, much less aliasing
+  };
+  Waveshaper(Curve initialCurve = Curve::TANH, Mode initialMode = Mode::TABLE,
+             int maximumBlockSize = pdlSettings::bufferSize);//for oversampling
+  float process(float input);//main per-sample function
+  void processBlock(const float* input, float* output, int numberOfSamples);
+  void reset();//clear ADAA and oversampling history
+
+  void setCurve(Curve newCurve);//calculates the table
+  //any function of one float returning a float, called for every point of the table
+  template<typename Function>
+  void setCustomCurve(Function newCurve);
+  void setMode(Mode newMode);
+  void setDriveDB(float newDriveDB);//ramps over the next block
+  void setOutputGainDB(float newOutputGainDB);//ramps over the next block
+  void setOversampling(int newFactor);//1 (off), 2, 4 or 8, allocates
+  void setOversamplingFilter(Oversampler::Filter newFilter);//allocates
+
+  Curve getCurve();
+  Mode getMode();
+  float getDriveDB();
+  float getOutputGainDB();
+  int getOversampling();
+  Oversampler::Filter getOversamplingFilter();
+  float getSample();
+  float getLatency();//(samples) ADAA and oversampling
+  int getLatencyInSamples();//rounded
+
+  private:
+  static const int tableSize = 4096;//segments from -tableRange to tableRange
+  static constexpr float tableRange = 8.0f;
+  template<bool antiderivative>
+  void shape(float* samples, int numberOfSamples, float drive, float driveStep,
+             float gain, float gainStep);
+  template<bool antiderivative>
+  static void lookUp(float* samples, float* inputs, double* areas, const float* curveTable,
+                     const double* integralTable, int numberOfSamples, float drive, float driveStep,
+                     float gain, float gainStep);//the part of shape() for each sample alone
+  void integrate();//antiderivative of the (interpolated) curve
+  double antiderivativeAt(float x);
+  Curve curve;
+  Mode mode;
+  Oversampler oversampler;
+  std::vector<float> transfer;//tableSize + 2, the last repeated
+  std::vector<double> integral;//tableSize + 2, 0.0 at the center (input 0.0)
+  float driveDB, outputGainDB;
+  float linearDrive, linearOutputGain;//the targets
+  float currentDrive, currentOutputGain;//reached at the end of the last block
+  float lastInput;//after drive
+  double lastIntegral;//ADAA
+  std::vector<float> driven;//inputs after drive, one block at the oversampled rate + 1
+  std::vector<double> antiderivatives;//of each, ADAA
+  float currentSample;
+};
+
+template<typename Function>
+void Waveshaper::setCustomCurve(Function newCurve){
+  curve = Curve::CUSTOM;
+  for(int i = 0; i <= tableSize; i++){
+    float x = -tableRange + 2.0f * tableRange * static_cast<float>(i) / tableSize;
+    transfer[i] = static_cast<float>(newCurve(x));
+  }
+  integrate();
+}
+#endif
+/*
+On antiderivative antialiasing
+
+A waveshaper only knows the input at each sample, and jumps straight
+from the curve's value at one sample to its value at the next. Between
+the two the input moved through every value from one to the other, and
+the output should have followed the curve the whole way. ADAA outputs
+the average of the curve over that movement instead: the difference of
+the curve's antiderivative at the two inputs, divided by the difference
+of the inputs. This average is a gentle low pass on the harmonics the
+curve makes, taken before they can alias (Parker, Zavalishin and Le
+Bivic, "Reducing the aliasing of nonlinear waveshaping using continuous
+time convolution", 2016).
+
+When two inputs are almost equal that division is 0.0 / 0.0, and the
+average is simply the curve's value there. Rather than testing for it
+every sample, a tiny step is added to both differences, which blends
+toward the curve's value only when the inputs are that close.
+Quiet or slow signals move by far less than the table's spacing from
+one sample to the next, so the difference of the antiderivatives has
+to be precise well below it. The table stores the antiderivative
+exactly for the interpolated curve, in double precision and measured
+from 0.0 (so it stays small for quiet input), and the position in the
+table is found in double as well; in float, the position alone would
+round the input to about 0.000001.
+Averaging over the last sample delays the output by half a sample.
+*/
@@ -3,6 +3,7 @@
 
 #define _USE_MATH_DEFINES
 #include <cmath>
+#include <memory>
 #include "utilities.hpp"
 #include "pdlSettings.hpp"
 /*
@@ -10,7 +11,11 @@ Windows are generally used to gradually scale the amplitude of
 an array of samples to zero at both ends. The shape of a window
 has spectral implications. The correct choice of window function
 is dependent upon application. 
+
+generateSample() reads the window from a shared table (see
+WindowTable); the functions at the bottom calculate it directly.
 */
+class WindowTable;
 class Window {
   public:
   Window();
@@ -43,6 +48,8 @@ class Window {
   float phase, phaseIncrement;
   Window::Mode currentMode;
   float currentSample;
+  static const int tableSize = 4096;//points, interpolated between
+  std::shared_ptr<const WindowTable> table;//for currentMode
   
   //functions used to calculate windows
   //can be used without creating a Window object
@@ -0,0 +1,59 @@
+#ifndef WindowTable_hpp
+#define WindowTable_hpp
+
+#include <memory>
+#include <vector>
+#include "Window.hpp"
+/*
+A window calculated once and shared by everything that uses the same
+shape and size.
+
+Window::hanningFromPhase() and friends call cos() (or exp()) every
+time. Code that applies a window over and over (every STFT frame,
+every grain) should read a table instead. get() returns the table for
+a shape and size, calculating it only if nothing else is using it
+already (like the FFT tables STFT shares). Tables are read only, and
+are released when the last user lets go.
+
+The table is 'periodic': data() holds 'size' points, the window
+repeating every 'size' samples, which is what overlap-add needs for
+perfect reconstruction. One more point (the end of the window) follows,
+so lookup() can read the window at any phase from 0.0 to 1.0, for
+windows of any length.
+
+For resynthesis by overlap-add, the overlapping windows sum to a gain
+that has to be divided out. getOverlapAddGain() gives it for windows
+applied once (analysis or synthesis only) or twice (both), and
+getOverlapAddRipple() how far from constant the sum is at that hop size
+(0.0 for perfect reconstruction, such as HANNING at 1/2 or 1/4 hops).
+
+std::shared_ptr<const WindowTable> hann = WindowTable::get(Window::Mode::HANNING, 1024);
+float gain = hann->getOverlapAddGain(256, true);//analysis and synthesis windows
+*/
+class WindowTable{
+  public:
+  //control thread only, may allocate (and lock)
+  static std::shared_ptr<const WindowTable> get(Window::Mode mode, int size);
+
+  const float* data() const {return samples.data();}//size + 1 points
+  int getSize() const {return size;}
+  Window::Mode getMode() const {return mode;}
+  //window at phase 0.0 to 1.0 (clamped), interpolated between points
+  inline float lookup(float phase) const {
+    float position = clamp(phase, 0.0f, 1.0f) * size;
+    int point = std::min(static_cast<int>(position), size - 1);
+    return samples[point] + (samples[point + 1] - samples[point]) * (position - point);
+  }
+  float getSum() const;//of the periodic window
+  float getSumOfSquares() const;
+  float getOverlapAddGain(int hopSize, bool squared) const;//squared: windowed twice
+  float getOverlapAddRipple(int hopSize, bool squared) const;//largest difference from the gain, relative
+
+  private:
+  WindowTable(Window::Mode mode, int size);
+  Window::Mode mode;
+  int size;
+  std::vector<float> samples;
+  double sum, sumOfSquares;
+};
+#endif
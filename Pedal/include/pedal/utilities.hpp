@@ -5,6 +5,7 @@
 #define _USE_MATH_DEFINES
 #include <cmath>
 #include "pdlSettings.hpp"
+#include "FastMath.hpp"
 #include "algorithm"
 
 float msToSamples(float timeInMS);
@@ -19,8 +20,6 @@ template<class T>
 T dBToAmplitude(T dB){
   return std::pow(10.0, dB/20.0);
 }
-//temporary stereo panner until spatialization system is added
-void panStereo(float input, float position, float* outputFrame);
 //void normalize(float* inputBuffer, int bufferSize, float min, float max);//normalize data in place
 float rangedRandom(float minimum, float maximum);
 
@@ -38,6 +37,14 @@ T clamp(T input, U lowerBound, V upperBound){
     return result;
   }
 }
+//temporary stereo panner until spatialization system is added.
+//constant power, position -1.0 is all right and 1.0 all left. Inline and
+//without calls to sin()/cos(), so it is cheap enough for every voice, every sample
+inline void panStereo(float input, float position, float* outputFrame){
+  float cycles = (clamp(position, -1.0f, 1.0f) + 1.0f) * 0.125f;//0 to a quarter cycle
+  outputFrame[0] = fastSinCycles<SineAccuracy::MEDIUM>(cycles) * input;
+  outputFrame[1] = fastCosCycles<SineAccuracy::MEDIUM>(cycles) * input;
+}
 
  /*
 This class is a low pass filter for control
@@ -6,10 +6,10 @@
 Buffer::Buffer(float initialDuration){
   numberChannels = 1;
   outputFormat.container = drwav_container_riff;// <-- drwav_container_riff = normal WAV files, drwav_container_w64 = Sony Wave64.
-  outputFormat.format = DR_WAVE_FORMAT_PCM; // <-- Any of the DR_WAVE_FORMAT_* codes.
+  outputFormat.format = DR_WAVE_FORMAT_IEEE_FLOAT; // <-- Any of the DR_WAVE_FORMAT_* codes.
   outputFormat.channels = 1;
   outputFormat.sampleRate = pdlSettings::sampleRate;
-  outputFormat.bitsPerSample = 16;
+  outputFormat.bitsPerSample = 32;//samples are written without conversion
   setDuration(initialDuration);
 }
 
@@ -17,14 +17,16 @@ Buffer::Buffer(const Buffer& other) {
   duration = other.duration;
   durationInSamples = other.durationInSamples;
   numberChannels = other.numberChannels;
+  outputFormat = other.outputFormat;
   content = new float[durationInSamples * numberChannels];
-  std::memcpy(content, other.content, durationInSamples * sizeof(float));
+  std::memcpy(content, other.content, durationInSamples * numberChannels * sizeof(float));
 }
 
 Buffer::Buffer(Buffer&& other) noexcept {
   duration = other.duration;
   durationInSamples = other.durationInSamples;
   numberChannels = other.numberChannels;
+  outputFormat = other.outputFormat;
   content = other.content;
   other.content = nullptr;
 }
@@ -33,6 +35,7 @@ Buffer& Buffer::operator=(const Buffer& other) {
   duration = other.duration;
   durationInSamples = other.durationInSamples;
   numberChannels = other.numberChannels;
+  outputFormat = other.outputFormat;
   delete[] content; // delete what we have
   content = new float[durationInSamples * numberChannels];
   std::memcpy(content, other.content, durationInSamples * numberChannels * sizeof(float));
@@ -66,7 +69,7 @@ void Buffer::addToSample(float inputSample, int index, int channel){
   index = clamp(index, 0, durationInSamples-1);
   content[index * numberChannels + channel] += inputSample;
 }
-void Buffer::loadSoundFile(const char* pathToFile){
+bool Buffer::loadSoundFile(const char* pathToFile){
     float* temporaryPointer;
     temporaryPointer = drwav_open_file_and_read_pcm_frames_f32(pathToFile,
                                                        &fileChannels, 
@@ -75,23 +78,32 @@ void Buffer::loadSoundFile(const char* pathToFile){
                                                        NULL);
   if (temporaryPointer == nullptr) {//if the loading failed
     std::cout << "error loading soundfile" << std::endl;
+    return false;
   }else{//if the file successfully loaded
-  //TODO adjust for sampling rate differences
-    //how many samples long is the buffer?
     numberChannels = fileChannels;
-    std::cout << fileSampleRate << std::endl;
-    durationInSamples = totalFramesInFile;
-    setDurationInSamples(durationInSamples);
-    content = temporaryPointer; 
+    if(fileSampleRate == static_cast<unsigned>(pdlSettings::sampleRate)){
+      //how many samples long is the buffer?
+      setDurationInSamples(totalFramesInFile);//frees the previous content
+      //dr_wav allocated with its own allocator; copy into content and give it back
+      std::memcpy(content, temporaryPointer, durationInSamples * numberChannels * sizeof(float));
+    }else{//convert once now, so playback needs no extra interpolation
+      Resampler converter(fileSampleRate, pdlSettings::sampleRate);
+      setDurationInSamples(converter.getOutputLength(totalFramesInFile));
+      converter.process(temporaryPointer, totalFramesInFile, content, numberChannels);
+    }
+    drwav_free(temporaryPointer, NULL);
   }
+  return true;
 }
 void Buffer::writeSoundFile(const char* pathToFile){
-  drwav_init_file_write_sequential_pcm_frames(&wavTemp, "data/recording.wav", &outputFormat, durationInSamples, NULL);
-
-  drwav_uint64 framesWritten = drwav_write_pcm_frames(&wavTemp, 
-                                                     durationInSamples,//how many frames 
-                                                     content );
-  std::cout << framesWritten/pdlSettings::sampleRate << std::endl;
+  //content is written as it is stored (32 bit float); see Recorder for other formats
+  outputFormat.channels = numberChannels;
+  if(!drwav_init_file_write_sequential_pcm_frames(&wavTemp, pathToFile, &outputFormat, durationInSamples, NULL)){
+    std::cout << "error creating soundfile" << std::endl;
+    return;
+  }
+  drwav_write_pcm_frames(&wavTemp, durationInSamples, content);
+  drwav_uninit(&wavTemp);//finish and close the file
 }
 
 void Buffer::fillSineSweep(float lowFrequency, float highFrequency){
@@ -118,26 +130,21 @@ void Buffer::setDuration(float newDuration){
   duration = newDuration;
   delete[] content;
   durationInSamples = msToSamples(duration);
-  content = new float[durationInSamples * numberChannels];
-  for(int i = 0; i < durationInSamples; i++){
-    content[i] = 0.0f;
-  }
+  content = new float[durationInSamples * numberChannels]();//every channel silent
 }
 void Buffer::setDurationInSamples(unsigned long newDurationInSamples){
     durationInSamples = newDurationInSamples;
     duration = samplesToMS(durationInSamples);
     delete[] content;
-    content = new float[durationInSamples * numberChannels];
-    for(int i = 0; i < durationInSamples; i++){
-      content[i] = 0.0f;
-    }
+    content = new float[durationInSamples * numberChannels]();//every channel silent
 }
 
-float Buffer::getDuration(){return duration;}
+float Buffer::getDuration() const {return duration;}
 float* Buffer::getContent(){return content;}
-unsigned long Buffer::getDurationInSamples(){return durationInSamples;}
-int Buffer::getNumberChannels(){return numberChannels;}
-float Buffer::getSample(float index, int channel){
+const float* Buffer::getContent() const {return content;}
+unsigned long Buffer::getDurationInSamples() const {return durationInSamples;}
+int Buffer::getNumberChannels() const {return numberChannels;}
+float Buffer::getSample(float index, int channel) const {
   index = clamp(index, 0.0f, durationInSamples-1);//clamp for safety
   int interleavedIndex = index * numberChannels + channel;
   float retrievedSample = 0.0f;//start with a sample
@@ -150,7 +157,7 @@ float Buffer::getSample(float index, int channel){
   retrievedSample = linearInterpolation(index, previousSample, nextSample);
   return retrievedSample;
 }
-float Buffer::getSample(int index, int channel){
+float Buffer::getSample(int index, int channel) const {
   index = clamp(index, 0.0f, durationInSamples-1);//clamp for safety
   return content[index * numberChannels + channel];
 }
\ No newline at end of file
@@ -1,7 +1,10 @@
 #include "pedal/BufferPlayer.hpp"
 
 //Constructors and deconstructors=====================
-BufferPlayer::BufferPlayer(Buffer* reference){//constructor (default)
+BufferPlayer::BufferPlayer(const Buffer* reference){//constructor (default)
+  bufferReference = nullptr;
+  streamReference = nullptr;
+  numberChannels = 0;//until there is a reference
   if(reference != nullptr){//if the reference isn't invalid (it is by default)
     bufferReference = reference;//assign the input as the reference
     assignDataFromReference(reference);//extract and assign data from this reference
@@ -13,10 +16,18 @@ BufferPlayer::BufferPlayer(Buffer* reference){//constructor (default)
   isPlaying = true;//on by default
   interpolationMode = LINEAR;//most common interpolation mode
   direction = 1.0f;//forward -1.0f is backward
+  sincWeights.assign(SincTable::maximumTaps, 0.0f);
+}
+BufferPlayer::BufferPlayer(DiskBuffer* stream) : BufferPlayer(static_cast<const Buffer*>(nullptr)){
+  setReference(stream);
+}
+BufferPlayer::BufferPlayer(std::shared_ptr<const Buffer> sample) : BufferPlayer(static_cast<const Buffer*>(nullptr)){
+  setReference(sample);
 }
 
 //Core functionality of class=========================
 float BufferPlayer::update(){//function called per-sample
+  if(streamReference != nullptr){return updateStream();}
   if(bufferReference != nullptr){//if a buffer reference exists (can't play nothing)
     if(isPlaying){//if not paused/stopped
       for(int i = 0; i < numberChannels; i++){//for every audio channel in the buffer
@@ -28,19 +39,22 @@ float BufferPlayer::update(){//function called per-sample
           case LINEAR://Look at value before, and value ahead. choose value based on this
           { //*this process is explained in more detail at the bottom of this document
             float previousSample = bufferReference->getSample((int)index, i);
-            float nextSample = bufferReference->getSample(wrapIndex((int)index + numberChannels), i);
+            float nextSample = bufferReference->getSample(wrapIndex((int)index + 1), i);
             currentFrame[i] = linearInterpolation(index, previousSample, nextSample);
           }
           break;
           case CUBIC://look two samples back and two samples forward to determine the value
           {//*this process is explained in more detail at the bottom of this document
-            float backTwo = bufferReference->getSample(wrapIndex((int)index - numberChannels), i);
+            float backTwo = bufferReference->getSample(wrapIndex((int)index - 1), i);
             float backOne = bufferReference->getSample((int)index, i);
-            float forwardOne = bufferReference->getSample(wrapIndex((int)index + numberChannels), i);
-            float forwardTwo = bufferReference->getSample(wrapIndex((int)index + numberChannels * 2), i);
+            float forwardOne = bufferReference->getSample(wrapIndex((int)index + 1), i);
+            float forwardTwo = bufferReference->getSample(wrapIndex((int)index + 2), i);
             currentFrame[i] = cubicInterpolation(index,backTwo,backOne,forwardOne,forwardTwo);
           }
           break;
+          case SINC://every channel at once, a filter's worth of samples around the index
+          if(i == 0){sincFrameWrapped(currentFrame.data());}
+          break;
         }
       }
       //after the sample is acquired, update the playback position(index)
@@ -77,13 +91,224 @@ float BufferPlayer::update(){//function called per-sample
   }//end of nullptr reference check
   return currentFrame[0];
 }//end of fucntion
-void BufferPlayer::assignDataFromReference(Buffer* reference){
+float BufferPlayer::updateStream(){
+  if(isPlaying){
+    //move forward, reading a new frame from the stream for every whole sample passed
+    streamPosition += std::fabs(playSpeed);
+    bool reachedEnd = false;//the last frame of the file is now the previous frame
+    while(streamPosition >= 1.0f){
+      std::copy(streamFrames.begin() + numberChannels, streamFrames.end(), streamFrames.begin());
+      reachedEnd = reachedEnd || streamReference->isFinished();
+      streamReference->readFrames(&streamFrames[numberChannels], 1);
+      streamPosition -= 1.0f;
+    }
+    for(int i = 0; i < numberChannels; i++){
+      if(interpolationMode == NONE){
+        currentFrame[i] = streamFrames[i];
+      }else{
+        currentFrame[i] = linearInterpolation(streamPosition, streamFrames[i], streamFrames[numberChannels + i]);
+      }
+    }
+    if(playMode == ONE_SHOT && reachedEnd){
+      stop();
+    }
+  }
+  return currentFrame[0];
+}
+namespace{
+//one frame of every channel, from pointers to the frames around the index
+template<InterpolationMode mode>
+inline void interpolateFrame(const float* backTwo, const float* backOne, const float* forwardOne,
+                             const float* forwardTwo, float position, float** output, int outputIndex,
+                             int numberChannels){
+  for(int channel = 0; channel < numberChannels; channel++){
+    float sample;
+    if(mode == NONE){
+      sample = backOne[channel];
+    }else if(mode == LINEAR){
+      sample = backOne[channel] + (forwardOne[channel] - backOne[channel]) * position;
+    }else{//the same polynomial as cubicInterpolation(), in Horner form
+      float a = -0.5f * backTwo[channel] + 1.5f * backOne[channel] - 1.5f * forwardOne[channel] + 0.5f * forwardTwo[channel];
+      float b = backTwo[channel] - 2.5f * backOne[channel] + 2.0f * forwardOne[channel] - 0.5f * forwardTwo[channel];
+      float c = -0.5f * backTwo[channel] + 0.5f * forwardOne[channel];
+      sample = ((a * position + b) * position + c) * position + backOne[channel];
+    }
+    output[channel][outputIndex] = sample;
+  }
+}
+}
+
+void BufferPlayer::render(float** output, int numberOfFrames){
+  if(streamReference != nullptr){//streams are read a frame at a time anyway
+    for(int i = 0; i < numberOfFrames; i++){
+      updateStream();
+      for(int channel = 0; channel < numberChannels; channel++){output[channel][i] = currentFrame[channel];}
+    }
+    return;
+  }
+  if(bufferReference == nullptr || numberOfFrames <= 0){return;}
+  if(bufferReference->getDurationInSamples() == 0){
+    for(int channel = 0; channel < numberChannels; channel++){
+      std::fill(output[channel], output[channel] + numberOfFrames, 0.0f);
+    }
+    return;
+  }
+  switch(interpolationMode){//chosen once per block
+    case NONE: renderMode<NONE>(output, numberOfFrames); break;
+    case LINEAR: renderMode<LINEAR>(output, numberOfFrames); break;
+    case CUBIC: renderMode<CUBIC>(output, numberOfFrames); break;
+    case SINC: renderMode<SINC>(output, numberOfFrames); break;
+  }
+  for(int channel = 0; channel < numberChannels; channel++){
+    currentFrame[channel] = output[channel][numberOfFrames - 1];//as if update() had been called
+  }
+}
+template<InterpolationMode mode>
+void BufferPlayer::renderMode(float** output, int numberOfFrames){
+  switch(playMode){
+    case ONE_SHOT: renderSpans<mode, ONE_SHOT>(output, numberOfFrames); break;
+    case LOOP: renderSpans<mode, LOOP>(output, numberOfFrames); break;
+    case PING_PONG: renderSpans<mode, PING_PONG>(output, numberOfFrames); break;
+  }
+}
+template<InterpolationMode mode, PlayMode edge>
+void BufferPlayer::renderSpans(float** output, int numberOfFrames){
+  const float* content = bufferReference->getContent();
+  const long length = static_cast<long>(bufferReference->getDurationInSamples());
+  //the SINC filter for this speed, the same for the whole block
+  const SincTable& sincTable = SincTable::get();
+  const int sincLevel = sincTable.getLevel(playSpeed);
+  const int sincTaps = sincTable.getTaps(sincLevel);
+  //frames whose neighbours are all inside the buffer: firstSafe <= index < safeEnd
+  const long before = mode == SINC ? sincTaps / 2 - 1 : mode == CUBIC ? 1 : 0;
+  const long after = mode == SINC ? sincTaps / 2 : mode == CUBIC ? 2 : mode == LINEAR ? 1 : 0;
+  const float firstSafe = static_cast<float>(before);
+  const float safeEnd = static_cast<float>(length - after);
+  const int stride = numberChannels;
+  int frame = 0;
+  while(frame < numberOfFrames){
+    if(!isPlaying){//hold the last frame, as update() does
+      for(int channel = 0; channel < numberChannels; channel++){
+        std::fill(output[channel] + frame, output[channel] + numberOfFrames, currentFrame[channel]);
+      }
+      return;
+    }
+    float step = playSpeed * direction;
+    //how many frames can be read before the index leaves the safe region.
+    //rounded down, so the last one is at least a whole step inside
+    long span = 0;
+    if(index >= firstSafe && index < safeEnd){
+      if(step > 0.0f){
+        span = static_cast<long>((safeEnd - index) / step);
+      }else if(step < 0.0f){
+        span = static_cast<long>((index - firstSafe) / -step);
+      }else{
+        span = numberOfFrames - frame;
+      }
+      span = std::min(span, static_cast<long>(numberOfFrames - frame));
+    }
+    for(long i = 0; i < span; i++){//no wrapping or edges in here
+      long whole = static_cast<long>(index);
+      const float* backOne = content + whole * stride;
+      if(mode == SINC){
+        sincTable.getWeights(sincLevel, index - whole, sincWeights.data());
+        const float* first = backOne - before * stride;
+        for(int channel = 0; channel < numberChannels; channel++){
+          float sum = 0.0f;
+          if(stride == 1){
+            sum = dotProduct(sincWeights.data(), first, sincTaps);
+          }else{
+            for(int k = 0; k < sincTaps; k++){sum += sincWeights[k] * first[k * stride + channel];}
+          }
+          output[channel][frame + i] = sum;
+        }
+        index += step;
+        continue;
+      }
+      interpolateFrame<mode>(mode == CUBIC ? backOne - stride : backOne, backOne,
+                             mode == NONE ? backOne : backOne + stride,
+                             mode == CUBIC ? backOne + 2 * stride : backOne,
+                             index - whole, output, frame + static_cast<int>(i), numberChannels);
+      index += step;
+    }
+    frame += static_cast<int>(span);
+    if(frame < numberOfFrames){//one frame near an end, the careful way
+      renderWrappedFrame<mode>(output, frame);
+      for(int channel = 0; channel < numberChannels; channel++){currentFrame[channel] = output[channel][frame];}
+      index += step;
+      handleEdge<edge>();
+      frame++;
+    }
+  }
+}
+template<InterpolationMode mode>
+void BufferPlayer::renderWrappedFrame(float** output, int frame){
+  if(mode == SINC){
+    sincFrameWrapped(currentFrame.data());
+    for(int channel = 0; channel < numberChannels; channel++){output[channel][frame] = currentFrame[channel];}
+    return;
+  }
+  const float* content = bufferReference->getContent();
+  long length = static_cast<long>(bufferReference->getDurationInSamples());
+  long whole = clamp(static_cast<long>(index), 0L, length - 1);//as getSample() does
+  auto wrapped = [&](long offset){
+    return content + ((whole + offset) % length + length) % length * numberChannels;
+  };
+  interpolateFrame<mode>(wrapped(-1), wrapped(0), wrapped(1), wrapped(2),
+                         index - static_cast<long>(index), output, frame, numberChannels);
+}
+void BufferPlayer::sincFrameWrapped(float* frame){
+  const SincTable& sincTable = SincTable::get();
+  int level = sincTable.getLevel(playSpeed);
+  int taps = sincTable.getTaps(level);
+  const float* content = bufferReference->getContent();
+  long length = static_cast<long>(bufferReference->getDurationInSamples());
+  long whole = clamp(static_cast<long>(index), 0L, length - 1);
+  sincTable.getWeights(level, index - static_cast<long>(index), sincWeights.data());
+  for(int channel = 0; channel < numberChannels; channel++){frame[channel] = 0.0f;}
+  for(int k = 0; k < taps; k++){
+    long position = ((whole - taps / 2 + 1 + k) % length + length) % length;
+    for(int channel = 0; channel < numberChannels; channel++){
+      frame[channel] += sincWeights[k] * content[position * numberChannels + channel];
+    }
+  }
+}
+template<PlayMode edge>
+void BufferPlayer::handleEdge(){
+  float length = static_cast<float>(bufferReference->getDurationInSamples());
+  if(edge == ONE_SHOT){
+    if(index > length || index < 0.0f){stop();}
+  }else if(edge == LOOP){
+    if(index > length){
+      index -= length;
+    }else if(index < 0.0f){
+      index += length;
+    }
+  }else{//PING_PONG, bounce back from either end the same distance it overshot
+    if(index > length){
+      index -= (index - length) * 2.0f;
+      reverseDirection();
+    }
+    if(index < 0.0f){
+      index = std::fabs(index);
+      reverseDirection();
+    }
+  }
+}
+void BufferPlayer::assignDataFromReference(const Buffer* reference){
   numberChannels = reference->getNumberChannels();
-  delete[] currentFrame;//free previous frame memory
-  currentFrame = new float[numberChannels];//allocate new memory
+  currentFrame.assign(numberChannels, 0.0f);
   totalSampleCount = reference->getDurationInSamples() * //sample length of one channel
                      reference->getNumberChannels();
 }
+void BufferPlayer::assignDataFromStream(DiskBuffer* stream){
+  numberChannels = stream->getNumberChannels();
+  currentFrame.assign(numberChannels, 0.0f);
+  streamFrames.assign(numberChannels * 2, 0.0f);
+  streamPosition = 0.0f;
+  totalSampleCount = stream->getDurationInSamples() * numberChannels;
+  stream->setLooping(playMode != ONE_SHOT);
+}
 int BufferPlayer::wrapIndex(int inputIndex){
   return (inputIndex + bufferReference->getDurationInSamples()) % 
           bufferReference->getDurationInSamples();
@@ -91,6 +316,7 @@ int BufferPlayer::wrapIndex(int inputIndex){
 void BufferPlayer::stop(){
   isPlaying = false;
   index = 0.0f;
+  if(streamReference != nullptr){streamReference->seek(0);}
 }
 void BufferPlayer::play(){
   isPlaying = true;
@@ -102,7 +328,8 @@ void BufferPlayer::reverseDirection(){
   direction *= -1.0f;
 }
 //getters and setters================================
-float* BufferPlayer::getFrame(){return currentFrame;}//return a pointer to the frame array
+float* BufferPlayer::getFrame(){return currentFrame.data();}//return a pointer to the frame array
+int BufferPlayer::getNumberChannels(){return numberChannels;}
 float BufferPlayer::getSample(int channel){//returns channel 0 if bad request
   if(channel < numberChannels){//is this a good request?
     return currentFrame[channel];
@@ -114,8 +341,22 @@ void BufferPlayer::setSpeed(float newSpeed){playSpeed = newSpeed;}
 void BufferPlayer::setPlayMode(PlayMode newPlayMode){
   playMode = newPlayMode;
   direction = 1.0f;//start forward, always. (this is only needed because of ping_pong mode)  
+  if(streamReference != nullptr){streamReference->setLooping(playMode != ONE_SHOT);}
+}
+void BufferPlayer::setReference(const Buffer* newReference){
+  bufferReference = newReference;
+  streamReference = nullptr;
+  sampleHandle = nullptr;
+  if(newReference != nullptr){assignDataFromReference(newReference);}
+}
+void BufferPlayer::setReference(std::shared_ptr<const Buffer> newSample){
+  setReference(newSample.get());
+  sampleHandle = std::move(newSample);
+}
+void BufferPlayer::setReference(DiskBuffer* newStream){
+  streamReference = newStream;
+  if(newStream != nullptr){assignDataFromStream(newStream);}
 }
-void BufferPlayer::setReference(Buffer* newReference){bufferReference = newReference;}
 void BufferPlayer::setInterpolationMode(InterpolationMode newMode){interpolationMode = newMode;}
 
 //=============further explenation
@@ -127,9 +368,10 @@ Because 60.3 is closer to 60 than it is to 61, expect the value at 60 to have mo
 influence on the calculated value.
 
 To find the indices, simply cast the index as an int to find the previous entry, and
-add one to this value to find the next. In this class, however, the buffer is interlieved.
-The sample stored immediately after the sample we are interested may belong to a different
-channel if there is more than one channel.Instead of adding 1, numberChannels is added.
+add one to this value to find the next. The buffer is interleaved, so the sample stored
+immediately after the one we are interested in may belong to a different channel. The
+index counts frames, though, and getSample(index, channel) finds the right channel within
+the frame, so adding 1 is still correct.
 
 Because it was needed often, I created a wrapIndex(int input) function. This function 
 checks the index against the size of the array, and wrapps it back around if necessary.
@@ -138,17 +380,17 @@ Finally, the getSample(index, channel) can take a channel value. We conveniently
 position in the for loop, i, for this.
 
 float prevoiusSample = bufferReference->getSample((int)index, i);
-float nextSample = bufferReference->getSample(wrapIndex((int)index + numberChannels), i);
+float nextSample = bufferReference->getSample(wrapIndex((int)index + 1), i);
 currentFrame[i] = linearInterpolation(index, previousSample, nextSample);
 
 In cubic interpolation, the story is very similar. The main difference is that this 
 type of interpolation requires two entries behind the index and two entries in front of 
 the index.
 
-float backTwo = bufferReference->getSample(wrapIndex((int)index - numberChannels), i);
+float backTwo = bufferReference->getSample(wrapIndex((int)index - 1), i);
 float backOne = bufferReference->getSample((int)index, i);
-float forwardOne = bufferReference->getSample(wrapIndex((int)index + numberChannels), i);
-float forwardTwo = bufferReference->getSample(wrapIndex((int)index + numberChannels * 2), i);
+float forwardOne = bufferReference->getSample(wrapIndex((int)index + 1), i);
+float forwardTwo = bufferReference->getSample(wrapIndex((int)index + 2), i);
 currentFrame[i] = cubicInterpolation(index,backTwo,backOne,forwardOne,forwardTwo);
 
 */
\ No newline at end of file
@@ -1,21 +1,32 @@
 #include "pedal/BufferedRMS.hpp"
 
 BufferedRMS::BufferedRMS(int samplePeriod){//how many samples to average
-  samplesToAverage = std::max(samplePeriod, 1);
-  sampleCounter = 0;
-  runningTotal = 0.0f;//c
-  writeIndex = 0;
-  periodReciprocal = 1.0f / (float)samplesToAverage;
-  sampleBuffer.setDurationInSamples(samplesToAverage);
-  //set the smoother time to sample period
+  setSamplePeriod(samplePeriod);
+}
+void BufferedRMS::processBlock(const float* input, float* output, int numberOfSamples){
+  for(int i = 0; i < numberOfSamples; i++){
+    output[i] = process(input[i]);
+  }
+}
+void BufferedRMS::recalculateTotal(){
+  //sum only the squares currently inside the window
+  runningTotal = 0.0;
+  for(int i = 1; i <= samplesToAverage; i++){
+    runningTotal += squaredHistory[(writeIndex - i) & indexMask];
+  }
 }
-
-
 void BufferedRMS::setSamplePeriod(int newSamplePeriod){
   samplesToAverage = std::max(newSamplePeriod, 1);
-  sampleCounter = 0;//reset the counter
-  runningTotal = 0.0f;//erase the running total
-  sampleBuffer.setDurationInSamples(samplesToAverage);
+  periodReciprocal = 1.0f / static_cast<float>(samplesToAverage);
+  int size = 1;
+  while(size < samplesToAverage){size *= 2;}//next power of two
+  squaredHistory.assign(size, 0.0f);//erase the history
+  indexMask = size - 1;
+  writeIndex = 0;
+  runningTotal = 0.0;//erase the running total
+  meanSquare = 0.0f;
+  currentSample = 0.0f;
 }
 int BufferedRMS::getSamplePeriod(){return samplesToAverage;}
-float BufferedRMS::getSample(){return currentSample;}
\ No newline at end of file
+float BufferedRMS::getSample(){return currentSample;}
+float BufferedRMS::getMeanSquare(){return meanSquare;}
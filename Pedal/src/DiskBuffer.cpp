@@ -0,0 +1,150 @@
+#include "pedal/DiskBuffer.hpp"
+#include <chrono>
+#include <cstring>//memset
+#include <iostream>
+
+DiskBuffer::DiskBuffer(float initialReadAheadTime){
+  readAheadTime = std::max(initialReadAheadTime, 10.0f);
+  fileIsOpen = false;
+  numberChannels = 1;
+  fileSampleRate = pdlSettings::sampleRate;
+  totalFrames = 0;
+  capacity = 1;
+  indexMask = 0;
+  looping = false;
+  running = false;
+  underrunCount = 0;
+}
+DiskBuffer::~DiskBuffer(){
+  close();
+}
+
+//Core functionality of class=========================
+bool DiskBuffer::open(const char* soundFilePath){
+  close();
+  if(!drwav_init_file(&wav, soundFilePath, NULL)){
+    std::cout << "error loading soundfile" << std::endl;
+    return false;
+  }
+  fileIsOpen = true;
+  numberChannels = wav.channels;
+  fileSampleRate = wav.sampleRate;
+  totalFrames = wav.totalPCMFrameCount;
+  //ring size is rounded up to a power of two, so wrapping is a bitwise 'and'
+  int framesAhead = std::max(static_cast<int>(msToSamples(readAheadTime)), 1024);
+  capacity = 1;
+  while(capacity < framesAhead){capacity *= 2;}
+  indexMask = capacity - 1;
+  ring.assign(capacity * numberChannels, 0.0f);
+  writeIndex = 0;
+  readIndex = 0;
+  seekTarget = 0;
+  seekRequest = 0;
+  seekAnswer = 0;
+  seekStartIndex = 0;
+  seekPending = 0;
+  endOfFile = false;
+  underrunCount = 0;
+  running = true;
+  ioThread = std::thread(&DiskBuffer::readAhead, this);
+  return true;
+}
+void DiskBuffer::close(){
+  running = false;
+  if(ioThread.joinable()){ioThread.join();}
+  if(fileIsOpen){
+    drwav_uninit(&wav);
+    fileIsOpen = false;
+  }
+}
+int DiskBuffer::readFrames(float* output, int numberOfFrames){
+  unsigned long long read = readIndex.load(std::memory_order_relaxed);
+  //has a seek been answered? Skip to where the new data begins
+  if(seekPending != 0){
+    if(seekAnswer.load(std::memory_order_acquire) == seekPending){
+      read = seekStartIndex.load(std::memory_order_relaxed);
+      readIndex.store(read, std::memory_order_release);
+      seekPending = 0;
+    }else{
+      std::memset(output, 0, numberOfFrames * numberChannels * sizeof(float));
+      return 0;
+    }
+  }
+  unsigned long long available = writeIndex.load(std::memory_order_acquire) - read;
+  int framesToCopy = static_cast<int>(std::min<unsigned long long>(available, numberOfFrames));
+  for(int i = 0; i < framesToCopy; i++){
+    const float* frame = &ring[((read + i) & indexMask) * numberChannels];
+    for(int channel = 0; channel < numberChannels; channel++){
+      output[i * numberChannels + channel] = frame[channel];
+    }
+  }
+  readIndex.store(read + framesToCopy, std::memory_order_release);
+  //anything missing is silence
+  int missing = numberOfFrames - framesToCopy;
+  if(missing > 0){
+    std::memset(output + framesToCopy * numberChannels, 0, missing * numberChannels * sizeof(float));
+    if(!isFinished()){underrunCount += missing;}
+  }
+  return framesToCopy;
+}
+void DiskBuffer::seek(unsigned long frame){
+  seekTarget.store(std::min(frame, totalFrames), std::memory_order_relaxed);
+  seekPending = seekRequest.load(std::memory_order_relaxed) + 1;
+  if(seekPending == 0){seekPending = 1;}//0 means 'no request'
+  seekRequest.store(seekPending, std::memory_order_release);
+}
+void DiskBuffer::readAhead(){
+  const int framesPerRead = 4096;
+  unsigned seekHandled = 0;
+  while(running.load(std::memory_order_relaxed)){
+    unsigned request = seekRequest.load(std::memory_order_acquire);
+    if(request != seekHandled){//the audio thread wants a new position
+      drwav_seek_to_pcm_frame(&wav, seekTarget.load(std::memory_order_relaxed));
+      endOfFile = false;
+      //everything already in the ring is before the new position
+      seekStartIndex.store(writeIndex.load(std::memory_order_relaxed), std::memory_order_relaxed);
+      seekAnswer.store(request, std::memory_order_release);
+      seekHandled = request;
+    }
+    if(endOfFile && looping.load(std::memory_order_relaxed)){//looping was turned on after the end
+      drwav_seek_to_pcm_frame(&wav, 0);
+      endOfFile = false;
+    }
+    unsigned long long write = writeIndex.load(std::memory_order_relaxed);
+    unsigned long long used = write - readIndex.load(std::memory_order_acquire);
+    int space = capacity - static_cast<int>(std::min<unsigned long long>(used, capacity));
+    if(space < framesPerRead / 4 || endOfFile){
+      //nothing to do; wait for the audio thread to read some frames
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      continue;
+    }
+    //read straight into the ring, up to its end (no wrap in a single read)
+    int position = static_cast<int>(write & indexMask);
+    int framesToRead = std::min(std::min(space, framesPerRead), capacity - position);
+    drwav_uint64 framesRead = drwav_read_pcm_frames_f32(&wav, framesToRead,
+                                                        &ring[position * numberChannels]);
+    writeIndex.store(write + framesRead, std::memory_order_release);
+    if(framesRead < static_cast<drwav_uint64>(framesToRead)){//reached the end of the file
+      if(looping.load(std::memory_order_relaxed) && totalFrames > 0){
+        drwav_seek_to_pcm_frame(&wav, 0);//continue from the beginning, no gap
+      }else{
+        endOfFile = true;
+      }
+    }
+  }
+}
+
+//getters and setters================================
+void DiskBuffer::setLooping(bool shouldLoop){
+  looping = shouldLoop;
+}
+bool DiskBuffer::isOpen(){return fileIsOpen;}
+bool DiskBuffer::isFinished(){
+  return endOfFile.load(std::memory_order_acquire) && seekPending == 0 &&
+         readIndex.load(std::memory_order_relaxed) == writeIndex.load(std::memory_order_acquire);
+}
+bool DiskBuffer::getLooping(){return looping;}
+int DiskBuffer::getNumberChannels(){return numberChannels;}
+unsigned DiskBuffer::getFileSampleRate(){return fileSampleRate;}
+unsigned long DiskBuffer::getDurationInSamples(){return totalFrames;}
+unsigned long DiskBuffer::getUnderrunCount(){return underrunCount;}
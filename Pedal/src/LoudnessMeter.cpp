@@ -0,0 +1,176 @@
+#include "pedal/LoudnessMeter.hpp"
+
+LoudnessMeter::LoudnessMeter(int numberOfChannels){
+  samplesPerStep = static_cast<int>(pdlSettings::sampleRate * 0.1f + 0.5f);//100ms
+  //each histogram bin stores its count; its power is taken from the bin center
+  for(int i = 0; i < histogramSize; i++){
+    double binCenter = -70.0 + i * 0.1;
+    binPowers[i] = std::pow(10.0, (binCenter + 0.691) / 10.0);
+  }
+  //windowed sinc, 4x oversampling. The filter is 48 taps long with its
+  //center at tap 24, so phase 0 would be a single 1.0 (the sample itself)
+  for(int phase = 1; phase < 4; phase++){
+    for(int tap = 0; tap < tapsPerPhase; tap++){
+      double position = (phase + 4 * tap - 24) / 4.0;//in input samples
+      double sinc = M_PI * position;
+      sinc = std::sin(sinc) / sinc;//position is never 0 outside phase 0
+      double window = 0.5 + 0.5 * std::cos(M_PI * position / 6.5);//hann
+      interpolationFilter[phase - 1][tap] = static_cast<float>(sinc * window);
+    }
+  }
+  setNumberOfChannels(numberOfChannels);
+}
+void LoudnessMeter::process(const float* frame){
+  for(int channel = 0; channel < channels; channel++){
+    float input = frame[channel];
+    float weighted = highPassFilters[channel].processSample(
+                     shelfFilters[channel].processSample(input));
+    stepTotals[channel] += weighted * weighted;
+    float peak = measureTruePeak(channel, input);
+    truePeaks[channel] = std::max(truePeaks[channel], peak);
+  }
+  peakWriteIndex++;
+  if(peakWriteIndex >= tapsPerPhase){peakWriteIndex = 0;}
+  stepSampleCount++;
+  if(stepSampleCount >= samplesPerStep){finishStep();}
+}
+void LoudnessMeter::processBlock(const float* input, int numberOfFrames){
+  for(int i = 0; i < numberOfFrames; i++){
+    process(input + i * channels);
+  }
+}
+float LoudnessMeter::measureTruePeak(int channel, float input){
+  //history is written twice so the last 12 samples are always in a row
+  float* history = &peakHistory[channel * 2 * tapsPerPhase];
+  history[peakWriteIndex] = input;
+  history[peakWriteIndex + tapsPerPhase] = input;
+  const float* oldestFirst = history + peakWriteIndex + 1;
+  //phase 0 is the sample 6 samples ago, which has already been measured.
+  //The newest sample is measured here so no peak is missed at the end
+  float peak = std::fabs(input);
+  for(int phase = 0; phase < 3; phase++){
+    float sum = 0.0f;
+    for(int tap = 0; tap < tapsPerPhase; tap++){
+      sum += oldestFirst[tap] * interpolationFilter[phase][tapsPerPhase - 1 - tap];
+    }
+    peak = std::max(peak, std::fabs(sum));
+  }
+  return peak;
+}
+void LoudnessMeter::finishStep(){
+  //weighted sum of the mean square of each channel
+  double power = 0.0;
+  for(int channel = 0; channel < channels; channel++){
+    power += channelWeights[channel] * stepTotals[channel];
+    stepTotals[channel] = 0.0;
+  }
+  power *= highPassScalar * highPassScalar / samplesPerStep;
+  stepPowers[stepWriteIndex] = power;
+  stepWriteIndex = (stepWriteIndex + 1) % stepsPerShortTerm;
+  stepSampleCount = 0;
+  stepsCompleted++;
+  //sliding windows. Only a few steps, so add them up again rather than
+  //keeping a running total (which would drift)
+  momentaryPower = 0.0;
+  shortTermPower = 0.0;
+  for(int i = 1; i <= stepsPerShortTerm; i++){
+    double stepPower = stepPowers[(stepWriteIndex - i + stepsPerShortTerm) % stepsPerShortTerm];
+    if(i <= stepsPerMomentary){momentaryPower += stepPower;}
+    shortTermPower += stepPower;
+  }
+  momentaryPower /= stepsPerMomentary;
+  shortTermPower /= stepsPerShortTerm;
+  //every complete 400ms block goes into the histogram (absolute gate at -70)
+  if(stepsCompleted >= stepsPerMomentary){
+    float loudness = powerToLUFS(momentaryPower);
+    if(loudness > -70.0f){
+      int bin = std::min(static_cast<int>((loudness + 70.0f) * 10.0f + 0.5f), histogramSize - 1);
+      histogram[bin]++;
+    }
+  }
+}
+float LoudnessMeter::powerToLUFS(double power){
+  if(power <= 0.0){return -INFINITY;}
+  return static_cast<float>(-0.691 + 10.0 * std::log10(power));
+}
+void LoudnessMeter::setKWeighting(){
+  //Filter values from ITU-R BS.1770. They are given as coefficients for
+  //48kHz; these are the matching analog parameters, so any rate works
+  const float shelfFrequency = 1681.974450955533f;
+  const float shelfGain = 3.999843853973347f;//dB
+  const float shelfQ = 0.7071752369554196f;
+  const float highPassFrequency = 38.13547087602444f;
+  const float highPassQ = 0.5003270373238773f;
+  //the standard high-pass uses a numerator of 1, -2, 1 (not scaled to 1.0
+  //in the pass band as Biquad is)
+  double k = std::tan(M_PI * highPassFrequency / pdlSettings::sampleRate);
+  highPassScalar = static_cast<float>(1.0 + k / highPassQ + k * k);
+  for(int channel = 0; channel < channels; channel++){
+    shelfFilters[channel].setBiquad(HIGH_SHELF, shelfFrequency, shelfQ, shelfGain);
+    highPassFilters[channel].setBiquad(HIGH_PASS, highPassFrequency, highPassQ, 0.0f);
+    shelfFilters[channel].flush();
+    highPassFilters[channel].flush();
+  }
+}
+void LoudnessMeter::reset(){
+  for(int channel = 0; channel < channels; channel++){
+    shelfFilters[channel].flush();
+    highPassFilters[channel].flush();
+  }
+  std::fill(stepTotals.begin(), stepTotals.end(), 0.0);
+  std::fill(stepPowers, stepPowers + stepsPerShortTerm, 0.0);
+  std::fill(histogram, histogram + histogramSize, 0);
+  std::fill(peakHistory.begin(), peakHistory.end(), 0.0f);
+  std::fill(truePeaks.begin(), truePeaks.end(), 0.0f);
+  stepSampleCount = 0;
+  stepWriteIndex = 0;
+  stepsCompleted = 0;
+  momentaryPower = 0.0;
+  shortTermPower = 0.0;
+  peakWriteIndex = 0;
+}
+
+//Getters and Setters===============================
+void LoudnessMeter::setNumberOfChannels(int newNumberOfChannels){
+  channels = std::max(newNumberOfChannels, 1);
+  shelfFilters.assign(channels, Biquad());
+  highPassFilters.assign(channels, Biquad());
+  channelWeights.assign(channels, 1.0f);
+  stepTotals.assign(channels, 0.0);
+  peakHistory.assign(channels * 2 * tapsPerPhase, 0.0f);
+  truePeaks.assign(channels, 0.0f);
+  setKWeighting();
+  reset();
+}
+void LoudnessMeter::setChannelWeight(int channel, float newWeight){
+  channelWeights[channel] = std::max(newWeight, 0.0f);
+}
+float LoudnessMeter::getMomentaryLoudness(){return powerToLUFS(momentaryPower);}
+float LoudnessMeter::getShortTermLoudness(){return powerToLUFS(shortTermPower);}
+float LoudnessMeter::getIntegratedLoudness(){
+  //level of every block that passed the absolute gate
+  long count = 0;
+  double total = 0.0;
+  for(int i = 0; i < histogramSize; i++){
+    count += histogram[i];
+    total += histogram[i] * binPowers[i];
+  }
+  if(count == 0){return -INFINITY;}
+  //relative gate, 10 LU below that level
+  float relativeGate = powerToLUFS(total / count) - 10.0f;
+  int firstBin = clamp(static_cast<int>((relativeGate + 70.0f) * 10.0f + 0.5f), 0, histogramSize - 1);
+  count = 0;
+  total = 0.0;
+  for(int i = firstBin; i < histogramSize; i++){
+    count += histogram[i];
+    total += histogram[i] * binPowers[i];
+  }
+  if(count == 0){return -INFINITY;}
+  return powerToLUFS(total / count);
+}
+float LoudnessMeter::getTruePeakDB(int channel){return amplitudeToDB(truePeaks[channel]);}
+float LoudnessMeter::getTruePeakDB(){
+  return amplitudeToDB(*std::max_element(truePeaks.begin(), truePeaks.end()));
+}
+float LoudnessMeter::getChannelWeight(int channel){return channelWeights[channel];}
+int LoudnessMeter::getNumberOfChannels(){return channels;}
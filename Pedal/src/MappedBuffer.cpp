@@ -0,0 +1,114 @@
+#include "pedal/MappedBuffer.hpp"
+#include <cstdint>
+#include <iostream>
+#include "dr_wav.h"//for reading the format of .wav files
+#if defined(__unix__) || defined(__APPLE__)
+#define PDL_MEMORY_MAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedBuffer::MappedBuffer(){
+  content = nullptr;
+  mapping = nullptr;
+  mappingSize = 0;
+  numberChannels = 1;
+  fileSampleRate = pdlSettings::sampleRate;
+  durationInSamples = 0;
+}
+MappedBuffer::~MappedBuffer(){
+  close();
+}
+
+//Core functionality of class=========================
+bool MappedBuffer::loadSoundFile(const char* soundFilePath){
+  close();
+  drwav wav;//only used to read the format
+  if(!drwav_init_file(&wav, soundFilePath, NULL)){
+    std::cout << "error loading soundfile" << std::endl;
+    return false;
+  }
+  numberChannels = wav.channels;
+  fileSampleRate = wav.sampleRate;
+  durationInSamples = wav.totalPCMFrameCount;
+  //samples may be used straight from the file if they are already
+  //little-endian 32 bit floats, aligned to 4 bytes
+  const std::uint16_t endianTest = 1;
+  bool littleEndian = *reinterpret_cast<const unsigned char*>(&endianTest) == 1;
+  bool floatSamples = wav.translatedFormatTag == DR_WAVE_FORMAT_IEEE_FLOAT &&
+                      wav.bitsPerSample == 32 && littleEndian &&
+                      wav.dataChunkDataPos % sizeof(float) == 0;
+  unsigned long long dataOffset = wav.dataChunkDataPos;
+  if(floatSamples && mapFile(soundFilePath, dataOffset)){
+    drwav_uninit(&wav);
+    return true;
+  }
+  //otherwise decode, as Buffer does
+  decodedContent.resize(durationInSamples * numberChannels);
+  durationInSamples = drwav_read_pcm_frames_f32(&wav, durationInSamples, decodedContent.data());
+  drwav_uninit(&wav);
+  content = decodedContent.data();
+  return true;
+}
+bool MappedBuffer::mapFile(const char* soundFilePath, unsigned long long dataOffset){
+#ifdef PDL_MEMORY_MAP
+  int file = open(soundFilePath, O_RDONLY);
+  if(file < 0){return false;}
+  struct stat fileInformation;
+  if(fstat(file, &fileInformation) != 0){
+    ::close(file);
+    return false;
+  }
+  unsigned long long fileSize = fileInformation.st_size;
+  //a truncated file can't be mapped safely; reading past its end would crash
+  unsigned long long dataSize = static_cast<unsigned long long>(durationInSamples) *
+                                numberChannels * sizeof(float);
+  if(dataOffset + dataSize > fileSize || dataSize == 0){
+    ::close(file);
+    return false;
+  }
+  void* address = mmap(nullptr, fileSize, PROT_READ, MAP_SHARED, file, 0);
+  ::close(file);//the mapping stays valid after the file is closed
+  if(address == MAP_FAILED){return false;}
+  mapping = address;
+  mappingSize = fileSize;
+  content = reinterpret_cast<const float*>(static_cast<const char*>(address) + dataOffset);
+  return true;
+#else
+  return false;
+#endif
+}
+void MappedBuffer::close(){
+#ifdef PDL_MEMORY_MAP
+  if(mapping != nullptr){munmap(mapping, mappingSize);}
+#endif
+  mapping = nullptr;
+  mappingSize = 0;
+  decodedContent.clear();
+  decodedContent.shrink_to_fit();
+  content = nullptr;
+  durationInSamples = 0;
+}
+
+//getters and setters================================
+float MappedBuffer::getSample(float index, int channel){
+  if(durationInSamples == 0){return 0.0f;}
+  index = clamp(index, 0.0f, static_cast<float>(durationInSamples - 1));//clamp for safety
+  unsigned long previous = static_cast<unsigned long>(index);
+  unsigned long next = std::min(previous + 1, durationInSamples - 1);
+  return linearInterpolation(index, content[previous * numberChannels + channel],
+                             content[next * numberChannels + channel]);
+}
+float MappedBuffer::getSample(int index, int channel){
+  if(durationInSamples == 0){return 0.0f;}
+  index = clamp(index, 0, static_cast<int>(durationInSamples - 1));//clamp for safety
+  return content[index * numberChannels + channel];
+}
+const float* MappedBuffer::getContent(){return content;}
+float MappedBuffer::getDuration(){return samplesToMS(durationInSamples);}
+unsigned long MappedBuffer::getDurationInSamples(){return durationInSamples;}
+int MappedBuffer::getNumberChannels(){return numberChannels;}
+unsigned MappedBuffer::getFileSampleRate(){return fileSampleRate;}
+bool MappedBuffer::isMapped(){return mapping != nullptr;}
@@ -0,0 +1,82 @@
+#include "pedal/MultichannelRMS.hpp"
+
+MultichannelRMS::MultichannelRMS(int numberOfChannels, int samplePeriod){
+  channels = std::max(numberOfChannels, 1);
+  samplesToAverage = std::max(samplePeriod, 1);
+  allocate();
+}
+void MultichannelRMS::process(const float* frame){
+  const int oldestIndex = (writeIndex - samplesToAverage) & indexMask;
+  const float* oldest = &squaredHistory[oldestIndex * channels];
+  float* newest = &squaredHistory[writeIndex * channels];
+  double* totals = runningTotals.data();
+  //read the oldest frame before it may be overwritten (when the period is a power of two)
+  for(int channel = 0; channel < channels; channel++){
+    float squared = frame[channel] * frame[channel];
+    totals[channel] += static_cast<double>(squared) - oldest[channel];
+    newest[channel] = squared;
+  }
+  writeIndex = (writeIndex + 1) & indexMask;
+  if(writeIndex == 0){recalculateTotals();}
+}
+void MultichannelRMS::processBlock(const float* input, int numberOfFrames){
+  for(int i = 0; i < numberOfFrames; i++){
+    process(input + i * channels);
+  }
+}
+void MultichannelRMS::recalculateTotals(){
+  std::fill(runningTotals.begin(), runningTotals.end(), 0.0);
+  double* totals = runningTotals.data();
+  for(int i = 1; i <= samplesToAverage; i++){
+    const float* frame = &squaredHistory[((writeIndex - i) & indexMask) * channels];
+    for(int channel = 0; channel < channels; channel++){
+      totals[channel] += frame[channel];
+    }
+  }
+}
+void MultichannelRMS::allocate(){
+  periodReciprocal = 1.0f / static_cast<float>(samplesToAverage);
+  int frames = 1;
+  while(frames < samplesToAverage){frames *= 2;}//next power of two
+  indexMask = frames - 1;
+  squaredHistory.assign(frames * channels, 0.0f);
+  runningTotals.assign(channels, 0.0);
+  writeIndex = 0;
+}
+
+//Getters and Setters===============================
+void MultichannelRMS::setNumberOfChannels(int newNumberOfChannels){
+  channels = std::max(newNumberOfChannels, 1);
+  allocate();
+}
+void MultichannelRMS::setSamplePeriod(int newSamplePeriod){
+  samplesToAverage = std::max(newSamplePeriod, 1);
+  allocate();
+}
+int MultichannelRMS::getNumberOfChannels(){return channels;}
+int MultichannelRMS::getSamplePeriod(){return samplesToAverage;}
+float MultichannelRMS::getMeanSquare(int channel){
+  //rounding may leave a tiny negative total after silence
+  return std::max(static_cast<float>(runningTotals[channel]) * periodReciprocal, 0.0f);
+}
+float MultichannelRMS::getRMS(int channel){return std::sqrt(getMeanSquare(channel));}
+float MultichannelRMS::getLevelDB(int channel){
+  return fastPowerToDB(getMeanSquare(channel) + 1.0e-20f);//avoid log(0)
+}
+void MultichannelRMS::getMeanSquares(float* output){
+  for(int channel = 0; channel < channels; channel++){
+    output[channel] = std::max(static_cast<float>(runningTotals[channel]) * periodReciprocal, 0.0f);
+  }
+}
+void MultichannelRMS::getRMS(float* output){
+  getMeanSquares(output);
+  for(int channel = 0; channel < channels; channel++){
+    output[channel] = std::sqrt(output[channel]);
+  }
+}
+void MultichannelRMS::getLevelsDB(float* output){
+  getMeanSquares(output);
+  for(int channel = 0; channel < channels; channel++){
+    output[channel] = fastPowerToDB(output[channel] + 1.0e-20f);
+  }
+}
@@ -0,0 +1,155 @@
+#include "pedal/PlanarBuffer.hpp"
+#include <cstdint>
+#include <cstring>//memcpy, memset
+#include <utility>//move
+
+//Constructors and deconstructors=====================
+PlanarBuffer::PlanarBuffer(int numberOfChannels, float initialDuration){
+  storage = nullptr;
+  alignedStorage = nullptr;
+  numberChannels = std::max(numberOfChannels, 1);
+  durationInSamples = static_cast<unsigned long>(msToSamples(std::max(initialDuration, 0.0f)));
+  allocate();
+}
+PlanarBuffer::PlanarBuffer(const PlanarBuffer& other){
+  storage = nullptr;
+  alignedStorage = nullptr;
+  numberChannels = other.numberChannels;
+  durationInSamples = other.durationInSamples;
+  allocate();
+  //padding included, strides are equal
+  std::memcpy(alignedStorage, other.alignedStorage, channelStride * numberChannels * sizeof(float));
+}
+PlanarBuffer::PlanarBuffer(PlanarBuffer&& other) noexcept{
+  storage = other.storage;
+  alignedStorage = other.alignedStorage;
+  channelStride = other.channelStride;
+  durationInSamples = other.durationInSamples;
+  numberChannels = other.numberChannels;
+  other.storage = nullptr;
+  other.alignedStorage = nullptr;
+  other.channelStride = 0;
+  other.durationInSamples = 0;
+}
+PlanarBuffer& PlanarBuffer::operator=(const PlanarBuffer& other){
+  if(this != &other){
+    PlanarBuffer copy(other);//if allocation fails, this buffer is unchanged
+    *this = std::move(copy);
+  }
+  return *this;
+}
+PlanarBuffer& PlanarBuffer::operator=(PlanarBuffer&& other) noexcept{
+  if(this != &other){
+    release();
+    storage = other.storage;
+    alignedStorage = other.alignedStorage;
+    channelStride = other.channelStride;
+    durationInSamples = other.durationInSamples;
+    numberChannels = other.numberChannels;
+    other.storage = nullptr;
+    other.alignedStorage = nullptr;
+    other.channelStride = 0;
+    other.durationInSamples = 0;
+  }
+  return *this;
+}
+PlanarBuffer::~PlanarBuffer(){
+  release();
+}
+void PlanarBuffer::allocate(){
+  release();
+  //round every channel up to a whole number of 'alignment' blocks,
+  //so if the first channel is aligned, every channel is
+  const unsigned long floatsPerBlock = alignment / sizeof(float);
+  channelStride = ((durationInSamples + floatsPerBlock - 1) / floatsPerBlock) * floatsPerBlock;
+  //allocate one block extra, then start at the first aligned address
+  storage = new float[channelStride * numberChannels + floatsPerBlock]();
+  std::uintptr_t address = reinterpret_cast<std::uintptr_t>(storage);
+  std::uintptr_t offset = (alignment - address % alignment) % alignment;
+  alignedStorage = storage + offset / sizeof(float);
+}
+void PlanarBuffer::release(){
+  delete[] storage;
+  storage = nullptr;
+  alignedStorage = nullptr;
+}
+
+//Core functionality of class=========================
+void PlanarBuffer::clear(){
+  std::memset(alignedStorage, 0, channelStride * numberChannels * sizeof(float));
+}
+void PlanarBuffer::readBlock(int channel, long start, float* output, int numberOfSamples){
+  const float* source = getChannelPointer(channel);
+  for(int i = 0; i < numberOfSamples; i++){
+    long index = start + i;
+    bool inside = index >= 0 && index < static_cast<long>(durationInSamples);
+    output[i] = inside ? source[index] : 0.0f;
+  }
+}
+void PlanarBuffer::writeBlock(int channel, long start, const float* input, int numberOfSamples){
+  //only the part of the block that lands inside the buffer
+  long first = std::max(start, 0L);
+  long last = std::min(start + numberOfSamples, static_cast<long>(durationInSamples));
+  if(last <= first){return;}
+  std::memcpy(getChannelPointer(channel) + first, input + (first - start), (last - first) * sizeof(float));
+}
+void PlanarBuffer::addBlock(int channel, long start, const float* input, int numberOfSamples){
+  long first = std::max(start, 0L);
+  long last = std::min(start + numberOfSamples, static_cast<long>(durationInSamples));
+  float* destination = getChannelPointer(channel);
+  for(long i = first; i < last; i++){
+    destination[i] += input[i - start];
+  }
+}
+void PlanarBuffer::readInterleaved(long start, float* output, int numberOfFrames){
+  for(int channel = 0; channel < numberChannels; channel++){
+    const float* source = getChannelPointer(channel);
+    for(int i = 0; i < numberOfFrames; i++){
+      long index = start + i;
+      bool inside = index >= 0 && index < static_cast<long>(durationInSamples);
+      output[i * numberChannels + channel] = inside ? source[index] : 0.0f;
+    }
+  }
+}
+void PlanarBuffer::writeInterleaved(long start, const float* input, int numberOfFrames){
+  long first = std::max(start, 0L);
+  long last = std::min(start + numberOfFrames, static_cast<long>(durationInSamples));
+  for(int channel = 0; channel < numberChannels; channel++){
+    float* destination = getChannelPointer(channel);
+    for(long i = first; i < last; i++){
+      destination[i] = input[(i - start) * numberChannels + channel];
+    }
+  }
+}
+
+//getters and setters================================
+void PlanarBuffer::setDuration(float newDuration){
+  setDurationInSamples(static_cast<unsigned long>(msToSamples(std::max(newDuration, 0.0f))));
+}
+void PlanarBuffer::setDurationInSamples(unsigned long newDurationInSamples){
+  durationInSamples = newDurationInSamples;
+  allocate();
+}
+void PlanarBuffer::setNumberChannels(int newNumberOfChannels){
+  numberChannels = std::max(newNumberOfChannels, 1);
+  allocate();
+}
+ChannelView PlanarBuffer::getChannel(int channel){
+  return ChannelView(getChannelPointer(channel), durationInSamples);
+}
+float* PlanarBuffer::getChannelPointer(int channel){
+  return alignedStorage + channelStride * clamp(channel, 0, numberChannels - 1);
+}
+void PlanarBuffer::writeSample(float inputSample, long index, int channel){
+  if(durationInSamples == 0){return;}
+  index = clamp(index, 0L, static_cast<long>(durationInSamples) - 1);
+  getChannelPointer(channel)[index] = inputSample;
+}
+float PlanarBuffer::getSample(long index, int channel){
+  if(durationInSamples == 0){return 0.0f;}
+  index = clamp(index, 0L, static_cast<long>(durationInSamples) - 1);
+  return getChannelPointer(channel)[index];
+}
+float PlanarBuffer::getDuration(){return samplesToMS(durationInSamples);}
+unsigned long PlanarBuffer::getDurationInSamples(){return durationInSamples;}
+int PlanarBuffer::getNumberChannels(){return numberChannels;}
@@ -0,0 +1,147 @@
+#include "pedal/Recorder.hpp"
+#include <chrono>
+#include <cstdint>
+#include <cstring>//memcpy
+#include <iostream>
+
+namespace{
+const int framesPerWrite = 4096;
+//float (-1.0 to 1.0) to a whole number, clipped to the range of 'bits'
+inline std::int32_t toInteger(float sample, int bits){
+  float maximum = static_cast<float>((1 << (bits - 1)) - 1);
+  sample = clamp(sample, -1.0f, 1.0f) * maximum;
+  return static_cast<std::int32_t>(sample + (sample >= 0.0f ? 0.5f : -0.5f));
+}
+}
+
+Recorder::Recorder(int numberOfChannels, float bufferTime){
+  numberChannels = std::max(numberOfChannels, 1);
+  int frames = std::max(static_cast<int>(msToSamples(bufferTime)), framesPerWrite);
+  capacity = 1;
+  while(capacity < frames){capacity *= 2;}//power of two, wrapping is a bitwise 'and'
+  indexMask = capacity - 1;
+  ring.assign(capacity * numberChannels, 0.0f);
+  encoded.resize(framesPerWrite * numberChannels * sizeof(float));//largest format
+  writeIndex = 0;
+  readIndex = 0;
+  running = false;
+  recording = false;
+  pushing = 0;
+  overflowCount = 0;
+  framesWritten = 0;
+  sampleFormat = SampleFormat::PCM_24;
+}
+Recorder::~Recorder(){
+  stop();
+}
+
+//Core functionality of class=========================
+bool Recorder::start(const char* soundFilePath, SampleFormat format, Container container){
+  stop();
+  drwav_data_format fileFormat;
+  fileFormat.container = container == Container::W64 ? drwav_container_w64 : drwav_container_riff;
+  fileFormat.channels = numberChannels;
+  fileFormat.sampleRate = pdlSettings::sampleRate;
+  if(format == SampleFormat::FLOAT_32){
+    fileFormat.format = DR_WAVE_FORMAT_IEEE_FLOAT;
+    fileFormat.bitsPerSample = 32;
+  }else{
+    fileFormat.format = DR_WAVE_FORMAT_PCM;
+    fileFormat.bitsPerSample = format == SampleFormat::PCM_16 ? 16 : 24;
+  }
+  if(!drwav_init_file_write(&wav, soundFilePath, &fileFormat, NULL)){
+    std::cout << "error creating soundfile" << std::endl;
+    return false;
+  }
+  sampleFormat = format;
+  writeIndex = 0;
+  readIndex = 0;
+  overflowCount = 0;
+  framesWritten = 0;
+  running = true;
+  writerThread = std::thread(&Recorder::writeLoop, this);
+  recording = true;
+  return true;
+}
+void Recorder::stop(){
+  if(!recording){return;}
+  recording = false;//pushFrames() stops accepting frames
+  //a pushFrames() that got past its check before that may still be copying
+  while(pushing.load() > 0){std::this_thread::yield();}
+  running = false;
+  if(writerThread.joinable()){writerThread.join();}
+  while(writeAvailable() > 0){}//anything pushed after the writer's last pass
+  drwav_uninit(&wav);//finishes the header with the final size
+}
+int Recorder::pushFrames(const float* input, int numberOfFrames){
+  //counted before the check, so stop() either sees this call or stops it
+  pushing.fetch_add(1);
+  if(!recording.load()){
+    pushing.fetch_sub(1, std::memory_order_release);
+    return 0;
+  }
+  unsigned long long write = writeIndex.load(std::memory_order_relaxed);
+  unsigned long long used = write - readIndex.load(std::memory_order_acquire);
+  int space = capacity - static_cast<int>(used);
+  int framesToCopy = std::min(numberOfFrames, space);
+  //copy in up to two pieces, before and after the end of the ring
+  int position = static_cast<int>(write & indexMask);
+  int firstPiece = std::min(framesToCopy, capacity - position);
+  std::memcpy(&ring[position * numberChannels], input, firstPiece * numberChannels * sizeof(float));
+  std::memcpy(&ring[0], input + firstPiece * numberChannels,
+              (framesToCopy - firstPiece) * numberChannels * sizeof(float));
+  writeIndex.store(write + framesToCopy, std::memory_order_release);
+  if(framesToCopy < numberOfFrames){
+    overflowCount.fetch_add(numberOfFrames - framesToCopy, std::memory_order_relaxed);
+  }
+  pushing.fetch_sub(1, std::memory_order_release);
+  return framesToCopy;
+}
+void Recorder::writeLoop(){
+  while(running.load(std::memory_order_relaxed)){
+    if(writeAvailable() == 0){
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+  }
+}
+int Recorder::writeAvailable(){
+  unsigned long long read = readIndex.load(std::memory_order_relaxed);
+  unsigned long long available = writeIndex.load(std::memory_order_acquire) - read;
+  int position = static_cast<int>(read & indexMask);
+  //one piece at a time, never past the end of the ring
+  int frames = static_cast<int>(std::min<unsigned long long>(available, framesPerWrite));
+  frames = std::min(frames, capacity - position);
+  if(frames == 0){return 0;}
+  const float* samples = &ring[position * numberChannels];
+  int numberOfSamples = frames * numberChannels;
+  unsigned char* bytes = encoded.data();
+  switch(sampleFormat){
+    case SampleFormat::PCM_16:
+    for(int i = 0; i < numberOfSamples; i++){
+      std::int16_t value = static_cast<std::int16_t>(toInteger(samples[i], 16));
+      std::memcpy(bytes + i * 2, &value, 2);//.wav is little endian, as is the host
+    }
+    break;
+    case SampleFormat::PCM_24:
+    for(int i = 0; i < numberOfSamples; i++){
+      std::int32_t value = toInteger(samples[i], 24);
+      bytes[i * 3] = static_cast<unsigned char>(value & 0xFF);//least significant byte first
+      bytes[i * 3 + 1] = static_cast<unsigned char>((value >> 8) & 0xFF);
+      bytes[i * 3 + 2] = static_cast<unsigned char>((value >> 16) & 0xFF);
+    }
+    break;
+    case SampleFormat::FLOAT_32:
+    std::memcpy(bytes, samples, numberOfSamples * sizeof(float));
+    break;
+  }
+  drwav_uint64 written = drwav_write_pcm_frames(&wav, frames, bytes);
+  readIndex.store(read + frames, std::memory_order_release);
+  framesWritten.fetch_add(static_cast<unsigned long>(written), std::memory_order_relaxed);
+  return frames;
+}
+
+//getters and setters================================
+bool Recorder::isRecording(){return recording;}
+int Recorder::getNumberChannels(){return numberChannels;}
+unsigned long Recorder::getOverflowCount(){return overflowCount;}
+unsigned long Recorder::getFramesWritten(){return framesWritten;}
@@ -0,0 +1,77 @@
+#include "pedal/SamplePool.hpp"
+
+//Constructors and deconstructors=====================
+SamplePool::SamplePool(){}
+SamplePool::~SamplePool(){}
+
+//Core functionality of class=========================
+SamplePool::Sample SamplePool::load(const char* soundFilePath){
+  Sample existing = find(soundFilePath);
+  if(existing){return existing;}
+  //load without the lock held, so other lookups don't wait on the disk
+  std::shared_ptr<Buffer> loaded = std::make_shared<Buffer>(0.0f);
+  if(!loaded->loadSoundFile(soundFilePath)){return nullptr;}
+  std::lock_guard<std::mutex> guard(poolLock);
+  //another thread may have loaded the same file meanwhile, keep the first
+  auto inserted = samples.insert(std::make_pair(std::string(soundFilePath), Sample(loaded)));
+  return inserted.first->second;
+}
+SamplePool::Sample SamplePool::find(const char* soundFilePath){
+  std::lock_guard<std::mutex> guard(poolLock);
+  auto found = samples.find(soundFilePath);
+  return found == samples.end() ? nullptr : found->second;
+}
+void SamplePool::release(const char* soundFilePath){
+  std::lock_guard<std::mutex> guard(poolLock);
+  auto found = samples.find(soundFilePath);
+  if(found == samples.end()){return;}
+  released.push_back(found->second);//still held, so no player can free it
+  samples.erase(found);
+}
+void SamplePool::releaseUnused(){
+  std::lock_guard<std::mutex> guard(poolLock);
+  for(auto entry = samples.begin(); entry != samples.end();){
+    if(entry->second.use_count() == 1){//only the pool holds it
+      released.push_back(entry->second);
+      entry = samples.erase(entry);
+    }else{
+      entry++;
+    }
+  }
+}
+int SamplePool::collect(){
+  std::vector<Sample> unused;
+  {
+    std::lock_guard<std::mutex> guard(poolLock);
+    //a released sample can't be found, so once nothing else holds it nothing can again
+    for(auto sample = released.begin(); sample != released.end();){
+      if(sample->use_count() == 1){
+        unused.push_back(std::move(*sample));
+        sample = released.erase(sample);
+      }else{
+        sample++;
+      }
+    }
+  }
+  return static_cast<int>(unused.size());//freed here, outside the lock
+}
+
+//getters and setters================================
+int SamplePool::getNumberSamples(){
+  std::lock_guard<std::mutex> guard(poolLock);
+  return static_cast<int>(samples.size());
+}
+int SamplePool::getNumberReleased(){
+  std::lock_guard<std::mutex> guard(poolLock);
+  return static_cast<int>(released.size());
+}
+unsigned long SamplePool::getMemoryUsage(){
+  std::lock_guard<std::mutex> guard(poolLock);
+  unsigned long total = 0;
+  for(const auto& entry : samples){total += bytesUsed(entry.second);}
+  for(const Sample& sample : released){total += bytesUsed(sample);}
+  return total;
+}
+unsigned long SamplePool::bytesUsed(const Sample& sample){
+  return sample->getDurationInSamples() * sample->getNumberChannels() * sizeof(float);
+}
@@ -0,0 +1,172 @@
+#include "pedal/Granulator.hpp"
+
+//Constructors and Deconstructors=========
+Granulator::Granulator(int initialMaximumGrains){
+  maximumGrains = std::max(initialMaximumGrains, 1);
+  activeGrains = 0;
+  readPosition.resize(maximumGrains);
+  readIncrement.resize(maximumGrains);
+  envelopePhase.resize(maximumGrains);
+  envelopeIncrement.resize(maximumGrains);
+  leftGain.resize(maximumGrains);
+  rightGain.resize(maximumGrains);
+  framesLeft.resize(maximumGrains);
+  startOffset.resize(maximumGrains);
+  source = nullptr;
+  framesUntilNextGrain = 0.0f;
+  setDensity(20.0f);
+  setDeviation(0.0f);
+  setMaskChance(0.0f);
+  setGrainDuration(100.0f);
+  setDurationDeviation(0.0f);
+  setPosition(0.0f);
+  setPositionDeviation(0.0f);
+  setSpeed(1.0f);
+  setPitchDeviation(0.0f);
+  setSpread(0.0f);
+  setAmplitude(1.0f);
+  setEnvelope(Window::Mode::HANNING);
+}
+
+//core functionality======================
+void Granulator::render(float** output, int numberOfFrames){
+  float* left = output[0];
+  float* right = output[1];
+  std::fill(left, left + numberOfFrames, 0.0f);
+  std::fill(right, right + numberOfFrames, 0.0f);
+  if(source == nullptr || source->getDurationInSamples() < 2){return;}
+  //every grain due in this block, as ImpulseGenerator would produce them
+  while(framesUntilNextGrain < numberOfFrames){
+    if(rangedRandom(0.0f, 1.0f) >= maskChance){
+      startGrain(static_cast<int>(std::max(framesUntilNextGrain, 0.0f)));
+    }
+    float halfPeriod = period * 0.5f;
+    framesUntilNextGrain += period + rangedRandom(-halfPeriod, halfPeriod) * deviation;
+  }
+  framesUntilNextGrain -= numberOfFrames;
+  //then each grain for the whole block, one at a time
+  const float* content = source->getContent();
+  const int stride = source->getNumberChannels();
+  const float* table = envelope->data();//envelopeSize + 1 points
+  int grain = 0;
+  while(grain < activeGrains){
+    int first = startOffset[grain];
+    int frames = std::min(framesLeft[grain], numberOfFrames - first);
+    float increment = readIncrement[grain];
+    //read relative to a sample at or before every one this block reaches, so the
+    //position in the loop is a small positive float (fast, and precise enough)
+    long base = static_cast<long>(readPosition[grain]);
+    if(increment < 0.0f){base = std::max(base - static_cast<long>(std::ceil(-increment * frames)) - 1, 0L);}
+    const float* samples = content + base * stride;
+    float offset = static_cast<float>(readPosition[grain] - base);
+    float phase = envelopePhase[grain];
+    float phaseIncrement = envelopeIncrement[grain];
+    float gainL = leftGain[grain];
+    float gainR = rightGain[grain];
+    //startGrain() made sure the whole grain is inside the source, so no checks here.
+    //positions are multiplied out rather than summed, so rounding doesn't build up
+    for(int n = 0; n < frames; n++){
+      float position = offset + n * increment;
+      int whole = static_cast<int>(position);
+      float previous = samples[whole * stride];
+      float sample = previous + (samples[(whole + 1) * stride] - previous) * (position - whole);
+      float envelopePosition = phase + n * phaseIncrement;
+      int point = std::min(static_cast<int>(envelopePosition), envelopeSize - 1);
+      float window = table[point] + (table[point + 1] - table[point]) * (envelopePosition - point);
+      sample *= window;
+      left[first + n] += sample * gainL;
+      right[first + n] += sample * gainR;
+    }
+    offset += frames * increment;
+    phase += frames * phaseIncrement;
+    framesLeft[grain] -= frames;
+    if(framesLeft[grain] <= 0){
+      removeGrain(grain);//the last grain moves here, and is rendered next
+    }else{
+      readPosition[grain] = base + static_cast<double>(offset);
+      envelopePhase[grain] = phase;
+      startOffset[grain] = 0;
+      grain++;
+    }
+  }
+}
+void Granulator::startGrain(int offset){
+  if(activeGrains >= maximumGrains){return;}//pool is full, skip
+  const double length = static_cast<double>(source->getDurationInSamples());
+  float increment = speed * std::pow(2.0f, rangedRandom(-pitchDeviation, pitchDeviation) / 12.0f);
+  int frames = static_cast<int>(msToSamples(grainDuration * (1.0f + rangedRandom(-durationDeviation, durationDeviation))));
+  //a grain can't read further than the source is long (in double: at speed 0.0
+  //the limit is far past the range of an int)
+  double reach = (length - 3.0) / std::max(static_cast<double>(std::fabs(increment)), 1.0e-6);
+  frames = static_cast<int>(std::min(reach, static_cast<double>(frames)));
+  if(frames < 1){return;}
+  double span = (frames - 1) * static_cast<double>(std::fabs(increment));
+  double start = position * (length - 1.0) + msToSamples(rangedRandom(-positionDeviation, positionDeviation));
+  //keep every frame of the grain (and the sample after it) inside the source,
+  //with a sample to spare either side for rounding
+  double lowest = increment >= 0.0f ? 1.0 : span + 1.0;
+  double highest = increment >= 0.0f ? length - 2.0 - span : length - 2.0;
+  start = clamp(start, lowest, highest);
+  float pan = rangedRandom(-spread, spread);//-1.0 left, 1.0 right
+  float angle = (pan + 1.0f) * static_cast<float>(M_PI) * 0.25f;//constant power
+  int grain = activeGrains++;
+  readPosition[grain] = start;
+  readIncrement[grain] = increment;
+  envelopePhase[grain] = 0.0f;
+  envelopeIncrement[grain] = static_cast<float>(envelopeSize) / frames;
+  leftGain[grain] = std::cos(angle) * amplitude;
+  rightGain[grain] = std::sin(angle) * amplitude;
+  framesLeft[grain] = frames;
+  startOffset[grain] = offset;
+}
+void Granulator::removeGrain(int grain){
+  int last = --activeGrains;
+  readPosition[grain] = readPosition[last];
+  readIncrement[grain] = readIncrement[last];
+  envelopePhase[grain] = envelopePhase[last];
+  envelopeIncrement[grain] = envelopeIncrement[last];
+  leftGain[grain] = leftGain[last];
+  rightGain[grain] = rightGain[last];
+  framesLeft[grain] = framesLeft[last];
+  startOffset[grain] = startOffset[last];
+}
+
+//Getters and Setters======================
+void Granulator::setSource(const Buffer* newSource){
+  source = newSource;
+  sourceHandle = nullptr;
+  activeGrains = 0;//their positions belong to the previous source
+}
+void Granulator::setSource(std::shared_ptr<const Buffer> newSource){
+  setSource(newSource.get());
+  sourceHandle = std::move(newSource);
+}
+void Granulator::setDensity(float newDensity){
+  density = std::max(std::fabs(newDensity), 0.001f);
+  period = pdlSettings::sampleRate / density;//in samples
+}
+void Granulator::setDeviation(float newDeviation){deviation = clamp(newDeviation, 0.0f, 1.0f);}
+void Granulator::setMaskChance(float newMaskChance){maskChance = clamp(newMaskChance, 0.0f, 1.0f);}
+void Granulator::setGrainDuration(float newDuration){grainDuration = std::max(newDuration, 0.0f);}
+void Granulator::setDurationDeviation(float newDeviation){durationDeviation = clamp(newDeviation, 0.0f, 1.0f);}
+void Granulator::setPosition(float newPosition){position = clamp(newPosition, 0.0f, 1.0f);}
+void Granulator::setPositionDeviation(float newDeviation){positionDeviation = std::fabs(newDeviation);}
+void Granulator::setSpeed(float newSpeed){speed = newSpeed;}
+void Granulator::setPitchDeviation(float newDeviation){pitchDeviation = std::fabs(newDeviation);}
+void Granulator::setSpread(float newSpread){spread = clamp(newSpread, 0.0f, 1.0f);}
+void Granulator::setAmplitude(float newAmplitude){amplitude = newAmplitude;}
+void Granulator::setEnvelope(Window::Mode newEnvelope){
+  envelopeMode = newEnvelope;
+  envelope = WindowTable::get(envelopeMode, envelopeSize);
+}
+
+int Granulator::getMaximumGrains(){return maximumGrains;}
+int Granulator::getActiveGrains(){return activeGrains;}
+float Granulator::getDensity(){return density;}
+float Granulator::getDeviation(){return deviation;}
+float Granulator::getMaskChance(){return maskChance;}
+float Granulator::getGrainDuration(){return grainDuration;}
+float Granulator::getPosition(){return position;}
+float Granulator::getSpeed(){return speed;}
+float Granulator::getSpread(){return spread;}
+Window::Mode Granulator::getEnvelope(){return envelopeMode;}
@@ -1,38 +1,28 @@
 #include "pedal/Window.hpp"
+#include "pedal/WindowTable.hpp"
 
 //Constructors and Deconstructors=============
 Window::Window(){
   setDuration(1000.0f);
+  setMode(Mode::HANNING);
   trigger = false;
+  active = false;
+  phase = 0.0f;
+  currentSample = 0.0f;
 }
 Window::Window(float initialDuration){
   setDuration(initialDuration);
+  setMode(Mode::HANNING);
   trigger = false;
+  active = false;
+  phase = 0.0f;
+  currentSample = 0.0f;
 }
 
 //Core functionality===========================
 float Window::generateSample(){
   if(active){
-    switch(currentMode){
-      case Mode::HANNING:
-        currentSample = hanningFromPhase(phase);
-      break;
-      case Mode::HAMMING:
-        currentSample = hammingFromPhase(phase);
-      break;
-      case Mode::COSINE:
-        currentSample = cosineFromPhase(phase);
-      break;
-      case Mode::TRIANGULAR:
-        currentSample = triangularFromPhase(phase);
-      break;
-      case Mode::BLACKMAN_NUTALL:
-        currentSample = blackmanNutallFromPhase(phase);
-      break;
-      case Mode::GAUSSIAN:
-        currentSample = gaussianFromPhase(phase);
-      break;
-    }
+    currentSample = table->lookup(phase);
     phase += phaseIncrement;
     if(phase > 1.0f){
       phase = 0.0f;
@@ -59,7 +49,12 @@ void Window::setDuration(float newDuration){
 void Window::setPhase(float newPhase){
   phase = clamp(newPhase, 0.0f, 1.0f);
 }
+void Window::setMode(Window::Mode newMode){
+  currentMode = newMode;
+  table = WindowTable::get(currentMode, tableSize);
+}
 float Window::getCurrentSample(){return currentSample;}
 float Window::getDuration(){return duration;}
 float Window::getPhase(){return phase;}
-bool Window::getActive(){return active;}
\ No newline at end of file
+bool Window::getActive(){return active;}
+Window::Mode Window::getMode(){return currentMode;}
\ No newline at end of file
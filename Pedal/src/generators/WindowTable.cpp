@@ -0,0 +1,60 @@
+#include "pedal/WindowTable.hpp"
+#include <map>
+#include <mutex>
+#include <utility>
+
+std::shared_ptr<const WindowTable> WindowTable::get(Window::Mode mode, int size){
+  size = std::max(size, 1);
+  static std::mutex cacheMutex;
+  static std::map<std::pair<int, int>, std::weak_ptr<const WindowTable>> cache;
+  std::lock_guard<std::mutex> lock(cacheMutex);
+  std::weak_ptr<const WindowTable>& entry = cache[std::make_pair(static_cast<int>(mode), size)];
+  std::shared_ptr<const WindowTable> table = entry.lock();
+  if(!table){
+    table.reset(new WindowTable(mode, size));//constructor is private, so no make_shared
+    entry = table;
+  }
+  return table;
+}
+WindowTable::WindowTable(Window::Mode initialMode, int initialSize){
+  mode = initialMode;
+  size = initialSize;
+  samples.resize(size + 1);
+  sum = 0.0;
+  sumOfSquares = 0.0;
+  for(int i = 0; i <= size; i++){
+    float phase = static_cast<float>(i) / size;
+    switch(mode){
+      case Window::Mode::HANNING: samples[i] = Window::hanningFromPhase(phase); break;
+      case Window::Mode::HAMMING: samples[i] = Window::hammingFromPhase(phase); break;
+      case Window::Mode::COSINE: samples[i] = Window::cosineFromPhase(phase); break;
+      case Window::Mode::TRIANGULAR: samples[i] = Window::triangularFromPhase(phase); break;
+      case Window::Mode::BLACKMAN_NUTALL: samples[i] = Window::blackmanNutallFromPhase(phase); break;
+      case Window::Mode::GAUSSIAN: samples[i] = Window::gaussianFromPhase(phase); break;
+    }
+    if(i < size){//the last point belongs to the next period
+      sum += samples[i];
+      sumOfSquares += static_cast<double>(samples[i]) * samples[i];
+    }
+  }
+}
+
+float WindowTable::getSum() const {return static_cast<float>(sum);}
+float WindowTable::getSumOfSquares() const {return static_cast<float>(sumOfSquares);}
+float WindowTable::getOverlapAddGain(int hopSize, bool squared) const {
+  //on average, each output sample is covered by size / hopSize windows
+  return static_cast<float>((squared ? sumOfSquares : sum) / std::max(hopSize, 1));
+}
+float WindowTable::getOverlapAddRipple(int hopSize, bool squared) const {
+  hopSize = clamp(hopSize, 1, size);
+  double gain = getOverlapAddGain(hopSize, squared);
+  double largest = 0.0;
+  for(int offset = 0; offset < hopSize; offset++){//every position within a hop
+    double total = 0.0;
+    for(int i = offset; i < size; i += hopSize){
+      total += squared ? static_cast<double>(samples[i]) * samples[i] : samples[i];
+    }
+    largest = std::max(largest, std::fabs(total - gain));
+  }
+  return static_cast<float>(largest / gain);
+}
@@ -0,0 +1,321 @@
+#include "pedal/AdditiveBank.hpp"
+
+namespace{
+  //4 term Blackman-Harris, sidelobes below -92dB
+  inline double blackmanHarris(double phase){
+    return 0.35875 - 0.48829 * std::cos(2.0 * M_PI * phase) +
+           0.14128 * std::cos(4.0 * M_PI * phase) - 0.01168 * std::cos(6.0 * M_PI * phase);
+  }
+}
+
+//Constructors and Deconstructors=========
+AdditiveBank::AdditiveBank(int initialMaximumPartials){
+  maximumPartials = std::max(initialMaximumPartials, 1);
+  numberPartials = maximumPartials;
+  //whole tiles, so the render loop never needs a partial tile
+  int padded = ((maximumPartials + laneCount - 1) / laneCount) * laneCount;
+  sine.assign(padded, 0.0f);
+  cosine.assign(padded, 1.0f);
+  rotationSine.assign(padded, 0.0f);
+  rotationCosine.assign(padded, 1.0f);
+  targetRotationSine.assign(padded, 0.0f);
+  targetRotationCosine.assign(padded, 1.0f);
+  frequency.assign(padded, 0.0f);
+  targetFrequency.assign(padded, 0.0f);
+  amplitude.assign(padded, 0.0f);
+  targetAmplitude.assign(padded, 0.0f);
+  phase.assign(padded, 0.0);
+  mode = Mode::OSCILLATORS;
+  fftSize = 0;
+  setFFTSize(1024);
+}
+
+//core functionality======================
+void AdditiveBank::render(float* output, int numberOfSamples){
+  if(numberOfSamples <= 0){return;}
+  if(mode == Mode::OSCILLATORS){
+    renderOscillators(output, numberOfSamples);
+  }else{
+    renderFrames(output, numberOfSamples);
+  }
+}
+void AdditiveBank::reset(){
+  std::fill(sine.begin(), sine.end(), 0.0f);
+  std::fill(cosine.begin(), cosine.end(), 1.0f);
+  std::fill(amplitude.begin(), amplitude.end(), 0.0f);//fade in again from silence
+  std::fill(phase.begin(), phase.end(), 0.0);
+  std::fill(overlap.begin(), overlap.end(), 0.0f);
+  readIndex = hopSize;
+}
+void AdditiveBank::renderOscillators(float* output, int numberOfSamples){
+  std::fill(output, output + numberOfSamples, 0.0f);
+  for(int first = 0; first < numberPartials; first += laneCount){
+    bool glide = false;
+    for(int lane = first; lane < first + laneCount; lane++){
+      //a silent partial takes its new frequency at once
+      if(amplitude[lane] == 0.0f){
+        frequency[lane] = targetFrequency[lane];
+        rotationSine[lane] = targetRotationSine[lane];
+        rotationCosine[lane] = targetRotationCosine[lane];
+      }
+      glide = glide || targetFrequency[lane] != frequency[lane];
+    }
+    //the frequency ramp doubles the work, so tiles only pay for it when they need it
+    if(glide){
+      renderTile<true>(first, output, numberOfSamples);
+    }else{
+      renderTile<false>(first, output, numberOfSamples);
+    }
+  }
+}
+template<bool glide>
+void AdditiveBank::renderTile(int first, float* output, int numberOfSamples){
+  //a tile's state lives in local arrays for the whole block, so the compiler
+  //can keep it in registers and run the lanes side by side
+  float s[laneCount], c[laneCount];
+  float rs[laneCount], rc[laneCount];
+  float gs[laneCount], gc[laneCount];
+  float a[laneCount], da[laneCount];
+  for(int lane = 0; lane < laneCount; lane++){
+    int partial = first + lane;
+    bool inUse = partial < numberPartials;
+    float start = inUse ? amplitude[partial] : 0.0f;
+    float end = inUse && isAudible(targetFrequency[partial]) ? targetAmplitude[partial] : 0.0f;
+    s[lane] = sine[partial];
+    c[lane] = cosine[partial];
+    rs[lane] = rotationSine[partial];
+    rc[lane] = rotationCosine[partial];
+    a[lane] = start;
+    da[lane] = (end - start) / numberOfSamples;
+    amplitude[partial] = end;
+    if(glide){
+      //the rotation itself rotates a little each sample, so the frequency moves
+      //linearly from one block's value to the next
+      double step = 2.0 * M_PI * (targetFrequency[partial] - frequency[partial]) /
+                    (numberOfSamples * pdlSettings::sampleRate);
+      gs[lane] = static_cast<float>(std::sin(step));
+      gc[lane] = static_cast<float>(std::cos(step));
+    }
+  }
+  for(int i = 0; i < numberOfSamples; i++){
+    float lanes[laneCount];
+    for(int lane = 0; lane < laneCount; lane++){
+      lanes[lane] = a[lane] * s[lane];
+      float nextSine = s[lane] * rc[lane] + c[lane] * rs[lane];
+      c[lane] = c[lane] * rc[lane] - s[lane] * rs[lane];
+      s[lane] = nextSine;
+      if(glide){
+        float nextRotationSine = rs[lane] * gc[lane] + rc[lane] * gs[lane];
+        float nextRotationCosine = rc[lane] * gc[lane] - rs[lane] * gs[lane];
+        //cos(step) is so close to 1.0 that rounding it would grow the rotation (and so
+        //the partial) a little every sample, so it is pulled back to the unit circle
+        float correction = 1.5f - 0.5f * (nextRotationSine * nextRotationSine + nextRotationCosine * nextRotationCosine);
+        rs[lane] = nextRotationSine * correction;
+        rc[lane] = nextRotationCosine * correction;
+      }
+      a[lane] += da[lane];
+    }
+    output[i] += ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) +
+                 ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+  }
+  const double samples = numberOfSamples;
+  for(int lane = 0; lane < laneCount; lane++){
+    int partial = first + lane;
+    //rounding in the phasor builds up over time, so each block starts again from
+    //the exact phase: the sum of every sample's rotation, gliding or not
+    double start = frequency[partial];
+    double end = targetFrequency[partial];
+    phase[partial] += (0.5 * (start + end) * samples - 0.5 * (end - start)) / pdlSettings::sampleRate;
+    phase[partial] -= std::floor(phase[partial]);
+    sine[partial] = fastSinCycles(static_cast<float>(phase[partial]));
+    cosine[partial] = fastCosCycles(static_cast<float>(phase[partial]));
+    //the exact rotation, rather than the end of the ramp
+    rotationSine[partial] = targetRotationSine[partial];
+    rotationCosine[partial] = targetRotationCosine[partial];
+    frequency[partial] = targetFrequency[partial];
+  }
+}
+void AdditiveBank::renderFrames(float* output, int numberOfSamples){
+  int written = 0;
+  while(written < numberOfSamples){
+    if(readIndex >= hopSize){synthesizeFrame();}
+    int count = std::min(numberOfSamples - written, hopSize - readIndex);
+    std::copy(ready.begin() + readIndex, ready.begin() + readIndex + count, output + written);
+    readIndex += count;
+    written += count;
+  }
+}
+void AdditiveBank::synthesizeFrame(){
+  std::fill(real.begin(), real.end(), 0.0f);
+  std::fill(imaginary.begin(), imaginary.end(), 0.0f);
+  const int nyquistBin = fftSize / 2;
+  const double binsPerHz = fftSize / pdlSettings::sampleRate;
+  const double cyclesPerHop = hopSize / pdlSettings::sampleRate;
+  for(int partial = 0; partial < numberPartials; partial++){
+    frequency[partial] = targetFrequency[partial];
+    rotationSine[partial] = targetRotationSine[partial];
+    rotationCosine[partial] = targetRotationCosine[partial];
+    float partialAmplitude = isAudible(frequency[partial]) ? targetAmplitude[partial] : 0.0f;
+    amplitude[partial] = partialAmplitude;
+    double partialPhase = phase[partial];
+    phase[partial] += frequency[partial] * cyclesPerHop;
+    phase[partial] -= std::floor(phase[partial]);
+    if(partialAmplitude == 0.0f){continue;}
+    double bin = std::fabs(frequency[partial]) * binsPerHz;
+    //a sine is a cosine a quarter cycle late. Negative frequencies play backward
+    double cosinePhase = (frequency[partial] < 0.0f ? 0.5 - partialPhase : partialPhase) - 0.25;
+    float halfReal = static_cast<float>(0.5 * partialAmplitude * std::cos(2.0 * M_PI * cosinePhase));
+    float halfImaginary = static_cast<float>(0.5 * partialAmplitude * std::sin(2.0 * M_PI * cosinePhase));
+    //the lobe at the partial's frequency, and its mirror images below 0 and above nyquist.
+    //The frame is centered on fftSize / 2, hence the sign that changes every bin
+    int lowest = std::max(static_cast<int>(std::ceil(bin - lobeHalfWidth)), 0);
+    int highest = std::min(static_cast<int>(bin + lobeHalfWidth), nyquistBin);
+    for(int k = lowest; k <= highest; k++){
+      float position = static_cast<float>(std::fabs(k - bin)) * lobeOversampling;
+      int point = static_cast<int>(position);
+      float weight = lobe[point] + (lobe[point + 1] - lobe[point]) * (position - point);
+      if(k & 1){weight = -weight;}
+      real[k] += weight * halfReal;
+      imaginary[k] += weight * halfImaginary;
+    }
+    highest = std::min(static_cast<int>(std::floor(lobeHalfWidth - bin)), nyquistBin);
+    for(int k = 0; k <= highest; k++){
+      float position = static_cast<float>(k + bin) * lobeOversampling;
+      int point = static_cast<int>(position);
+      float weight = lobe[point] + (lobe[point + 1] - lobe[point]) * (position - point);
+      if(k & 1){weight = -weight;}
+      real[k] += weight * halfReal;
+      imaginary[k] -= weight * halfImaginary;
+    }
+    lowest = std::max(static_cast<int>(std::ceil(fftSize - bin - lobeHalfWidth)), 0);
+    for(int k = lowest; k <= nyquistBin; k++){
+      float position = static_cast<float>(std::fabs(fftSize - bin - k)) * lobeOversampling;
+      int point = static_cast<int>(position);
+      float weight = lobe[point] + (lobe[point + 1] - lobe[point]) * (position - point);
+      if(k & 1){weight = -weight;}
+      real[k] += weight * halfReal;
+      imaginary[k] -= weight * halfImaginary;
+    }
+  }
+  fft.ifft(frame.data(), real.data(), imaginary.data());
+  //only the middle half of the frame is used, a hop either side of its center
+  const float* middle = frame.data() + fftSize / 4;
+  for(int i = 0; i < hopSize; i++){
+    ready[i] = overlap[i] + middle[i] * synthesisWindow[i];
+    overlap[i] = middle[hopSize + i] * synthesisWindow[hopSize + i];
+  }
+  readIndex = 0;
+}
+void AdditiveBank::preparePhasors(){
+  //phase is a hop past the last frame's center, and output has reached
+  //readIndex samples into the hop before that center
+  const double samplesBehind = 2.0 * hopSize - readIndex;
+  for(size_t partial = 0; partial < phase.size(); partial++){
+    phase[partial] -= frequency[partial] * samplesBehind / pdlSettings::sampleRate;
+    phase[partial] -= std::floor(phase[partial]);
+    sine[partial] = fastSinCycles(static_cast<float>(phase[partial]));
+    cosine[partial] = fastCosCycles(static_cast<float>(phase[partial]));
+  }
+}
+void AdditiveBank::prepareFrames(){
+  //a frame centered on the present, whose second half the next hop overlaps
+  std::fill(overlap.begin(), overlap.end(), 0.0f);
+  synthesizeFrame();
+  readIndex = hopSize;//its first half is in the past
+}
+void AdditiveBank::calculateLobe(){
+  //the window's spectrum (real, since the window is symmetric about the frame's center)
+  //from 0 to lobeHalfWidth bins, and one point more for interpolation
+  lobe.resize(lobeHalfWidth * lobeOversampling + 2);
+  std::vector<double> window(fftSize);
+  for(int n = 0; n < fftSize; n++){window[n] = blackmanHarris(static_cast<double>(n) / fftSize);}
+  for(size_t point = 0; point < lobe.size(); point++){
+    double bins = static_cast<double>(point) / lobeOversampling;
+    double sum = 0.0;
+    for(int n = 0; n < fftSize; n++){
+      sum += window[n] * std::cos(2.0 * M_PI * bins * (n - fftSize / 2) / fftSize);
+    }
+    lobe[point] = static_cast<float>(sum);
+  }
+  //undo the window in the middle half of the frame, and fade by a triangle instead
+  synthesisWindow.resize(2 * hopSize);
+  for(int i = 0; i < 2 * hopSize; i++){
+    double triangle = 1.0 - std::fabs(static_cast<double>(i - hopSize)) / hopSize;
+    synthesisWindow[i] = static_cast<float>(triangle / window[fftSize / 4 + i]);
+  }
+}
+bool AdditiveBank::isAudible(float partialFrequency){
+  return std::fabs(partialFrequency) < pdlSettings::sampleRate * 0.5;
+}
+
+//Getters and Setters======================
+void AdditiveBank::setNumberPartials(int newNumberPartials){
+  numberPartials = clamp(newNumberPartials, 0, maximumPartials);
+}
+void AdditiveBank::setPartial(int index, float newFrequency, float newAmplitude){
+  setFrequency(index, newFrequency);
+  setAmplitude(index, newAmplitude);
+}
+void AdditiveBank::setFrequency(int index, float newFrequency){
+  if(index < 0 || index >= maximumPartials){return;}
+  targetFrequency[index] = newFrequency;
+  double angle = 2.0 * M_PI * newFrequency / pdlSettings::sampleRate;
+  targetRotationSine[index] = static_cast<float>(std::sin(angle));
+  targetRotationCosine[index] = static_cast<float>(std::cos(angle));
+}
+void AdditiveBank::setAmplitude(int index, float newAmplitude){
+  if(index < 0 || index >= maximumPartials){return;}
+  targetAmplitude[index] = newAmplitude;
+}
+void AdditiveBank::setPhase(int index, float newPhase){
+  if(index < 0 || index >= maximumPartials){return;}
+  sine[index] = std::sin(newPhase);
+  cosine[index] = std::cos(newPhase);
+  phase[index] = newPhase / (2.0 * M_PI);
+}
+void AdditiveBank::setHarmonics(float fundamental, const float* amplitudes, int numberAmplitudes){
+  setNumberPartials(numberAmplitudes);
+  for(int i = 0; i < numberPartials; i++){
+    setPartial(i, fundamental * (i + 1), amplitudes[i]);
+  }
+}
+void AdditiveBank::setMode(Mode newMode){
+  if(newMode == mode){return;}
+  if(newMode == Mode::INVERSE_FFT){
+    prepareFrames();
+  }else{
+    preparePhasors();
+  }
+  mode = newMode;
+}
+void AdditiveBank::setFFTSize(int powerOfTwo){
+  //round up to nearest power of 2, as STFT does
+  int newSize = std::pow(2, std::ceil(std::log(std::max(powerOfTwo, 64)) / std::log(2.0f)));
+  if(newSize == fftSize){return;}
+  if(mode == Mode::INVERSE_FFT){preparePhasors();}//the present, in the old size
+  fftSize = newSize;
+  hopSize = fftSize / 4;
+  fft.init(fftSize);
+  real.resize(audiofft::AudioFFT::ComplexSize(fftSize));
+  imaginary.resize(audiofft::AudioFFT::ComplexSize(fftSize));
+  frame.resize(fftSize);
+  ready.assign(hopSize, 0.0f);
+  overlap.assign(hopSize, 0.0f);
+  readIndex = hopSize;
+  calculateLobe();
+  if(mode == Mode::INVERSE_FFT){prepareFrames();}
+}
+
+int AdditiveBank::getMaximumPartials(){return maximumPartials;}
+int AdditiveBank::getNumberPartials(){return numberPartials;}
+float AdditiveBank::getFrequency(int index){
+  if(index < 0 || index >= maximumPartials){return 0.0f;}
+  return targetFrequency[index];
+}
+float AdditiveBank::getAmplitude(int index){
+  if(index < 0 || index >= maximumPartials){return 0.0f;}
+  return targetAmplitude[index];
+}
+AdditiveBank::Mode AdditiveBank::getMode(){return mode;}
+int AdditiveBank::getFFTSize(){return fftSize;}
+int AdditiveBank::getHopSize(){return hopSize;}
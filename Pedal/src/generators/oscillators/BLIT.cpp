@@ -29,9 +29,8 @@ void BLIT::setNumberOfHarmonics(float newNumberOfHarmonics){
 void BLIT::setFrequency(float newFrequency){
   frequency = newFrequency;
   phaseIncrement = (0.5f *M_PI * frequency) / pdlSettings::sampleRate;
-  if(syncHarmonicsWithFrequency){
+  if(syncHarmonicsWithFrequency){//no printing here, this may be called every sample
     setNumberOfHarmonics(20000.0f/frequency);
-    std::cout << numberOfHarmonics << " : " << numberOfHarmonics * frequency << std::endl;
   }
 
 }
@@ -0,0 +1,316 @@
+#include "pedal/PolyBLEP.hpp"
+
+//constructors and deconstructors
+//=========================================================
+PolyBLEP::PolyBLEP(){
+  waveform = Waveform::SAW;
+  setFrequency(440.0f);
+  setPhase(0.0f);
+  setAmplitude(1.0f);
+  setPulseWidth(0.5f);
+  setSyncFrequency(0.0f);
+  currentSample = 0.0f;
+}
+PolyBLEP::PolyBLEP(float initialFrequency){
+  waveform = Waveform::SAW;
+  setFrequency(initialFrequency);
+  setPhase(0.0f);
+  setAmplitude(1.0f);
+  setPulseWidth(0.5f);
+  setSyncFrequency(0.0f);
+  currentSample = 0.0f;
+}
+PolyBLEP::~PolyBLEP(){
+  if(currentBlock != nullptr){
+    delete[] currentBlock;
+  }
+}
+
+//primary mechanics of class
+//=========================================================
+float PolyBLEP::generateSample(){
+  bool synced = syncIncrement > 0.0;
+  switch(waveform){
+    case Waveform::SAW:
+      currentSample = synced ? nextSyncedSample<Waveform::SAW>(phaseIncrement) :
+                               nextSample<Waveform::SAW>(phaseIncrement);
+      break;
+    case Waveform::PULSE:
+      currentSample = synced ? nextSyncedSample<Waveform::PULSE>(phaseIncrement) :
+                               nextSample<Waveform::PULSE>(phaseIncrement);
+      break;
+    case Waveform::TRIANGLE:
+      currentSample = synced ? nextSyncedSample<Waveform::TRIANGLE>(phaseIncrement) :
+                               nextSample<Waveform::TRIANGLE>(phaseIncrement);
+      break;
+  }
+  return currentSample;
+}
+float* PolyBLEP::generateBlock(){
+  if(currentBlock == nullptr){
+    currentBlock = new float[pdlSettings::bufferSize];
+  }
+  generateBlock(currentBlock, pdlSettings::bufferSize);
+  return currentBlock;
+}
+void PolyBLEP::generateBlock(float* output, int numberOfSamples){
+  generateBlock(output, nullptr, numberOfSamples);
+}
+void PolyBLEP::generateBlock(float* output, const float* frequencies, int numberOfSamples){
+  if(numberOfSamples <= 0){return;}
+  //choose the loop once per block, not once per sample
+  switch(waveform){
+    case Waveform::SAW: renderWaveform<Waveform::SAW>(output, frequencies, numberOfSamples); break;
+    case Waveform::PULSE: renderWaveform<Waveform::PULSE>(output, frequencies, numberOfSamples); break;
+    case Waveform::TRIANGLE: renderWaveform<Waveform::TRIANGLE>(output, frequencies, numberOfSamples); break;
+  }
+  currentSample = output[numberOfSamples - 1];
+}
+template<PolyBLEP::Waveform shapeToRender>
+void PolyBLEP::renderWaveform(float* output, const float* frequencies, int numberOfSamples){
+  if(syncIncrement > 0.0){
+    renderBlock<shapeToRender, true>(output, frequencies, numberOfSamples);
+  }else{
+    renderBlock<shapeToRender, false>(output, frequencies, numberOfSamples);
+  }
+}
+template<PolyBLEP::Waveform shapeToRender, bool synced>
+void PolyBLEP::renderBlock(float* output, const float* frequencies, int numberOfSamples){
+  if(!synced && frequencies == nullptr){
+    renderSteady<shapeToRender, false>(output, numberOfSamples, phase, phaseIncrement, pulseWidth, amplitude);
+    phase += numberOfSamples * phaseIncrement;
+    phase -= std::floor(phase);
+    return;
+  }
+  const double inverseSampleRate = 1.0 / pdlSettings::sampleRate;
+  double increment = phaseIncrement;
+  for(int i = 0; i < numberOfSamples; i++){
+    if(frequencies != nullptr){increment = frequencies[i] * inverseSampleRate;}
+    output[i] = synced ? nextSyncedSample<shapeToRender>(increment) : nextSample<shapeToRender>(increment);
+  }
+}
+template<PolyBLEP::Waveform shapeToRender, bool accumulate>
+void PolyBLEP::renderSteady(float* output, int numberOfSamples, double phase, double increment,
+                            float pulseWidth, float amplitude){
+  //phases are multiplied out from the start of a chunk, so the loop can use SIMD.
+  //Each chunk restarts from a phase calculated in double; multiplied out in
+  //float over a long block, the phase would drift (0.005 after a second)
+  const int samplesPerChunk = 64;
+  float step = static_cast<float>(increment);
+  float inverseIncrement = inverse(step);
+  for(int chunkStart = 0; chunkStart < numberOfSamples; chunkStart += samplesPerChunk){
+    int chunkSize = std::min(samplesPerChunk, numberOfSamples - chunkStart);
+    double chunkPhase = phase + increment * chunkStart;
+    float start = static_cast<float>(chunkPhase - std::floor(chunkPhase));
+    start = start >= 1.0f ? 0.0f : start;//just under 1.0 may round up to it
+    //start far enough on that a phase moving backward stays positive, so
+    //truncation is the same as floor()
+    start += step < 0.0f ? std::ceil(-step * chunkSize) : 0.0f;
+    float* chunk = output + chunkStart;
+    for(int i = 0; i < chunkSize; i++){
+      float position = start + i * step;
+      position -= static_cast<int>(position);
+      float sample = amplitude * shape<shapeToRender>(position, step, inverseIncrement, pulseWidth);
+      if(accumulate){
+        chunk[i] += sample;
+      }else{
+        chunk[i] = sample;
+      }
+    }
+  }
+}
+template<PolyBLEP::Waveform shapeToRender>
+float PolyBLEP::nextSample(double increment){
+  float step = static_cast<float>(increment);
+  float sample = shape<shapeToRender>(singlePrecision(phase), step, inverse(step), pulseWidth);
+  phase += increment;
+  phase -= std::floor(phase);//either way, for negative frequencies
+  return sample * amplitude;
+}
+template<PolyBLEP::Waveform shapeToRender>
+float PolyBLEP::nextSyncedSample(double increment){
+  //see bottom of header. Synced oscillators only move forward
+  float step = static_cast<float>(std::fabs(increment));
+  float start = singlePrecision(phase);
+  float sample = trivial<shapeToRender>(start) + nextCorrection;
+  nextCorrection = 0.0f;
+  bool restarts = syncPhase + syncIncrement >= 1.0;
+  //how far toward the next sample this oscillator runs before the master restarts it
+  float running = restarts ? static_cast<float>((1.0 - syncPhase) / syncIncrement) : 1.0f;
+  float reach = start + running * step;
+  //its own discontinuities on the way
+  switch(shapeToRender){
+    case Waveform::SAW:
+      if(reach >= 1.0f){smooth((1.0f - start) / step, -2.0f, 0.0f, sample);}
+      break;
+    case Waveform::PULSE:
+      if(start < pulseWidth && reach >= pulseWidth){smooth((pulseWidth - start) / step, -2.0f, 0.0f, sample);}
+      if(reach >= 1.0f){smooth((1.0f - start) / step, 2.0f, 0.0f, sample);}
+      break;
+    case Waveform::TRIANGLE:{
+      float cornerPhase = start + 0.25f;
+      cornerPhase -= cornerPhase >= 1.0f ? 1.0f : 0.0f;
+      float cornerReach = cornerPhase + running * step;
+      if(cornerPhase < 0.5f && cornerReach >= 0.5f){
+        smooth((0.5f - cornerPhase) / step, 0.0f, -8.0f * step, sample);
+      }
+      if(cornerReach >= 1.0f){smooth((1.0f - cornerPhase) / step, 0.0f, 8.0f * step, sample);}
+      break;
+    }
+  }
+  if(restarts){
+    float restartPhase = reach - std::floor(reach);
+    smooth(running, trivial<shapeToRender>(0.0f) - trivial<shapeToRender>(restartPhase),
+           (slope<shapeToRender>(0.0f) - slope<shapeToRender>(restartPhase)) * step, sample);
+    phase = (1.0f - running) * step;
+    syncPhase += syncIncrement - 1.0;
+  }else{
+    phase += step;
+    phase -= std::floor(phase);
+    syncPhase += syncIncrement;
+  }
+  return sample * amplitude;
+}
+template<PolyBLEP::Waveform shapeToRender>
+inline float PolyBLEP::trivial(float atPhase){
+  switch(shapeToRender){
+    case Waveform::SAW: return 2.0f * atPhase - 1.0f;
+    case Waveform::PULSE: return atPhase < pulseWidth ? 1.0f : -1.0f;
+    case Waveform::TRIANGLE:{
+      float cornerPhase = atPhase + 0.25f;
+      cornerPhase -= cornerPhase >= 1.0f ? 1.0f : 0.0f;
+      return 1.0f - 4.0f * std::fabs(cornerPhase - 0.5f);
+    }
+  }
+  return 0.0f;
+}
+template<PolyBLEP::Waveform shapeToRender>
+inline float PolyBLEP::slope(float atPhase){
+  switch(shapeToRender){
+    case Waveform::SAW: return 2.0f;
+    case Waveform::PULSE: return 0.0f;
+    case Waveform::TRIANGLE:{
+      float cornerPhase = atPhase + 0.25f;
+      cornerPhase -= cornerPhase >= 1.0f ? 1.0f : 0.0f;
+      return cornerPhase < 0.5f ? 4.0f : -4.0f;
+    }
+  }
+  return 0.0f;
+}
+inline float PolyBLEP::singlePrecision(double atPhase){
+  //just under 1.0 may round up to it, and 1.0 is the next cycle
+  float rounded = static_cast<float>(atPhase);
+  return rounded >= 1.0f ? 0.0f : rounded;
+}
+inline void PolyBLEP::smooth(float fraction, float step, float slopeChange, float& sample){
+  //blep: step * (1 - d)^2 / 2 before, -step * d^2 / 2 after.
+  //blamp: slopeChange * (1 - d)^3 / 6 before, slopeChange * d^3 / 6 after
+  float before = 1.0f - fraction;
+  sample += before * before * (0.5f * step + before * slopeChange * (1.0f / 6.0f));
+  nextCorrection += fraction * fraction * (-0.5f * step + fraction * slopeChange * (1.0f / 6.0f));
+}
+
+//Getters and setters
+//=========================================================
+void PolyBLEP::setWaveform(Waveform newWaveform){
+  waveform = newWaveform;
+  nextCorrection = 0.0f;
+}
+void PolyBLEP::setFrequency(float newFrequency){
+  frequency = newFrequency;
+  phaseIncrement = frequency / pdlSettings::sampleRate;
+}
+void PolyBLEP::setPhase(float newPhase){//expecting 0-TWO_PI
+  phase = newPhase / (2.0 * M_PI);
+  phase -= std::floor(phase);
+  syncPhase = 0.0;//the master starts again too
+  nextCorrection = 0.0f;
+}
+void PolyBLEP::setAmplitude(float newAmplitude){amplitude = newAmplitude;}
+void PolyBLEP::setPulseWidth(float newPulseWidth){pulseWidth = clamp(newPulseWidth, 0.0f, 1.0f);}
+void PolyBLEP::setSyncFrequency(float newSyncFrequency){
+  syncFrequency = std::fabs(newSyncFrequency);
+  syncIncrement = syncFrequency / pdlSettings::sampleRate;
+  nextCorrection = 0.0f;
+}
+
+PolyBLEP::Waveform PolyBLEP::getWaveform(){return waveform;}
+float PolyBLEP::getFrequency(){return frequency;}
+float PolyBLEP::getPhase(){return static_cast<float>(phase * 2.0 * M_PI);}
+float PolyBLEP::getAmplitude(){return amplitude;}
+float PolyBLEP::getPulseWidth(){return pulseWidth;}
+float PolyBLEP::getSyncFrequency(){return syncFrequency;}
+float PolyBLEP::getSample(){return currentSample;}
+float* PolyBLEP::getBlock(){return currentBlock;}
+
+//PolyBLEPBank=============================================
+PolyBLEPBank::PolyBLEPBank(int initialNumberVoices){
+  numberVoices = std::max(initialNumberVoices, 1);
+  waveform = PolyBLEP::Waveform::SAW;
+  phase.assign(numberVoices, 0.0);
+  increment.assign(numberVoices, 0.0);
+  pulseWidth.assign(numberVoices, 0.5f);
+  amplitude.assign(numberVoices, 1.0f);
+  for(int voice = 0; voice < numberVoices; voice++){setFrequency(voice, 440.0f);}
+}
+void PolyBLEPBank::render(float* output, int numberOfSamples){
+  switch(waveform){
+    case PolyBLEP::Waveform::SAW: renderVoices<PolyBLEP::Waveform::SAW, true>(&output, numberOfSamples); break;
+    case PolyBLEP::Waveform::PULSE: renderVoices<PolyBLEP::Waveform::PULSE, true>(&output, numberOfSamples); break;
+    case PolyBLEP::Waveform::TRIANGLE: renderVoices<PolyBLEP::Waveform::TRIANGLE, true>(&output, numberOfSamples); break;
+  }
+}
+void PolyBLEPBank::render(float** outputs, int numberOfSamples){
+  switch(waveform){
+    case PolyBLEP::Waveform::SAW: renderVoices<PolyBLEP::Waveform::SAW, false>(outputs, numberOfSamples); break;
+    case PolyBLEP::Waveform::PULSE: renderVoices<PolyBLEP::Waveform::PULSE, false>(outputs, numberOfSamples); break;
+    case PolyBLEP::Waveform::TRIANGLE: renderVoices<PolyBLEP::Waveform::TRIANGLE, false>(outputs, numberOfSamples); break;
+  }
+}
+template<PolyBLEP::Waveform shapeToRender, bool mix>
+void PolyBLEPBank::renderVoices(float** outputs, int numberOfSamples){
+  if(numberOfSamples <= 0){return;}
+  if(mix){std::fill(outputs[0], outputs[0] + numberOfSamples, 0.0f);}
+  for(int voice = 0; voice < numberVoices; voice++){
+    float* output = mix ? outputs[0] : outputs[voice];
+    PolyBLEP::renderSteady<shapeToRender, mix>(output, numberOfSamples, phase[voice], increment[voice],
+                                              pulseWidth[voice], amplitude[voice]);
+    //wrapped from a multiple of the increment as well, so it doesn't drift from a single PolyBLEP
+    double end = phase[voice] + increment[voice] * numberOfSamples;
+    phase[voice] = end - std::floor(end);
+  }
+}
+
+void PolyBLEPBank::setWaveform(PolyBLEP::Waveform newWaveform){waveform = newWaveform;}
+void PolyBLEPBank::setFrequency(int voice, float newFrequency){
+  if(voice < 0 || voice >= numberVoices){return;}
+  increment[voice] = newFrequency / pdlSettings::sampleRate;
+}
+void PolyBLEPBank::setPhase(int voice, float newPhase){
+  if(voice < 0 || voice >= numberVoices){return;}
+  double cycles = newPhase / (2.0 * M_PI);
+  phase[voice] = cycles - std::floor(cycles);
+}
+void PolyBLEPBank::setAmplitude(int voice, float newAmplitude){
+  if(voice < 0 || voice >= numberVoices){return;}
+  amplitude[voice] = newAmplitude;
+}
+void PolyBLEPBank::setPulseWidth(int voice, float newPulseWidth){
+  if(voice < 0 || voice >= numberVoices){return;}
+  pulseWidth[voice] = clamp(newPulseWidth, 0.0f, 1.0f);
+}
+
+PolyBLEP::Waveform PolyBLEPBank::getWaveform(){return waveform;}
+int PolyBLEPBank::getNumberVoices(){return numberVoices;}
+float PolyBLEPBank::getFrequency(int voice){
+  if(voice < 0 || voice >= numberVoices){return 0.0f;}
+  return static_cast<float>(increment[voice] * pdlSettings::sampleRate);
+}
+float PolyBLEPBank::getAmplitude(int voice){
+  if(voice < 0 || voice >= numberVoices){return 0.0f;}
+  return amplitude[voice];
+}
+float PolyBLEPBank::getPulseWidth(int voice){
+  if(voice < 0 || voice >= numberVoices){return 0.0f;}
+  return pulseWidth[voice];
+}
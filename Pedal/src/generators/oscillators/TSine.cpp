@@ -1,17 +1,24 @@
 #include "pedal/TSine.hpp"
+#include <algorithm>
 
 //constructors and deconstructors
 //=========================================================
 TSine::TSine(){//default constructor
+  mode = Mode::POLYNOMIAL;
+  accuracy = SineAccuracy::HIGH;
   setFrequency(440);
   setPhase(0.0);
   setAmplitude(1.0);
+  currentSample = 0.0f;
 }
 
 TSine::TSine(float frequency){//override constructor
+  mode = Mode::POLYNOMIAL;
+  accuracy = SineAccuracy::HIGH;
   setFrequency(frequency);
   setPhase(0.0);
   setAmplitude(1.0);
+  currentSample = 0.0f;
 }
 
 TSine::~TSine(){//when object is deleted
@@ -31,29 +38,106 @@ float* TSine::generateBlock(){//it is best to do all
   //calculations in a row if possible. This keeps the memory from 
   //jumping around looking for data
 
-  if(currentBlock != nullptr){//if we don't have a local currentBlock yet, 
+  if(currentBlock == nullptr){//if we don't have a local currentBlock yet, 
     currentBlock = new float[pdlSettings::bufferSize];//create a new array of floats
   }
+  generateBlock(currentBlock, pdlSettings::bufferSize);
+  return currentBlock;//returns pointer to the begining of this block
+}
 
-  for(int i = 0; i < pdlSettings::bufferSize; ++i){//for every sample in the buffer
-    currentBlock[i] = generateNextSample();
+void TSine::generateBlock(float* output, int numberOfSamples){
+  if(numberOfSamples <= 0){return;}
+  if(mode == Mode::QUADRATURE){
+    for(int i = 0; i < numberOfSamples; i++){
+      output[i] = static_cast<float>(sine) * amplitude;
+      rotate();
+    }
+    normalize();
+  }else{
+    //every phase is calculated from the start of a chunk (not added up), so
+    //there are no dependencies between samples and the loop can use SIMD.
+    //Each chunk restarts from the double phase; a float phase added up over a
+    //long block would lose precision (a 10 second block drifts by 0.004)
+    const int samplesPerChunk = 64;
+    float increment = static_cast<float>(phaseIncrement);
+    float gain = amplitude;//a local, so writing output can't change it (and the loop can use SIMD)
+    for(int chunkStart = 0; chunkStart < numberOfSamples; chunkStart += samplesPerChunk){
+      int chunkSize = std::min(samplesPerChunk, numberOfSamples - chunkStart);
+      float* chunk = output + chunkStart;
+      float start = static_cast<float>(phase);
+      switch(accuracy){
+        case SineAccuracy::LOW:
+        for(int i = 0; i < chunkSize; i++){
+          chunk[i] = fastSinCycles<SineAccuracy::LOW>(start + i * increment) * gain;
+        }
+        break;
+        case SineAccuracy::MEDIUM:
+        for(int i = 0; i < chunkSize; i++){
+          chunk[i] = fastSinCycles<SineAccuracy::MEDIUM>(start + i * increment) * gain;
+        }
+        break;
+        case SineAccuracy::HIGH:
+        for(int i = 0; i < chunkSize; i++){
+          chunk[i] = fastSinCycles<SineAccuracy::HIGH>(start + i * increment) * gain;
+        }
+        break;
+      }
+      phase += phaseIncrement * chunkSize;
+      phase -= std::floor(phase);
+    }
   }
-  return currentBlock;//returns pointer to the begining of this block
+  currentSample = output[numberOfSamples - 1];
+}
+
+void TSine::normalize(){
+  //close to 1.0, 1/sqrt(x) is very nearly 1.5 - 0.5x
+  double correction = 1.5 - 0.5 * (sine * sine + cosine * cosine);
+  sine *= correction;
+  cosine *= correction;
+  samplesSinceNormalized = 0;
+}
+void TSine::updatePhaseFromPhasor(){
+  phase = std::atan2(sine, cosine) / (2.0 * M_PI);
+  phase -= std::floor(phase);
 }
 
 //Getters and setters
 //=========================================================
 void TSine::setFrequency(float newFrequency){
   frequency = newFrequency;
-  phaseIncrement = (frequency * 2.0 * 3.1415926)/pdlSettings::sampleRate;//*see notes on bottom
+  phaseIncrement = frequency / static_cast<double>(pdlSettings::sampleRate);//*see notes on bottom
+  if(mode == Mode::QUADRATURE){
+    double angle = 2.0 * M_PI * phaseIncrement;
+    rotationSine = std::sin(angle);
+    rotationCosine = std::cos(angle);
+  }
+}
+void TSine::setPhase(float newPhase){
+  phase = newPhase / (2.0 * M_PI);//radians to cycles
+  phase -= std::floor(phase);
+  sine = std::sin(2.0 * M_PI * phase);
+  cosine = std::cos(2.0 * M_PI * phase);
+  samplesSinceNormalized = 0;
 }
-void TSine::setPhase(float newPhase){phase = newPhase;}
 void TSine::setAmplitude(float newAmplitude){amplitude = newAmplitude;}
+void TSine::setMode(Mode newMode){
+  if(mode == Mode::QUADRATURE){updatePhaseFromPhasor();}//continue from the same place
+  mode = newMode;
+  setPhase(static_cast<float>(phase * 2.0 * M_PI));
+  setFrequency(frequency);
+}
+void TSine::setAccuracy(SineAccuracy newAccuracy){accuracy = newAccuracy;}
 
 float TSine::getFrequency(){return frequency;}
+float TSine::getPhase(){
+  if(mode == Mode::QUADRATURE){updatePhaseFromPhasor();}
+  return static_cast<float>(phase * 2.0 * M_PI);
+}
 float TSine::getAmplitude(){return amplitude;}
 float TSine::getSample(){return currentSample;}
 float* TSine::getBlock(){return currentBlock;}
+TSine::Mode TSine::getMode(){return mode;}
+SineAccuracy TSine::getAccuracy(){return accuracy;}
 
 /*
 *Why is a phase increment needed? 
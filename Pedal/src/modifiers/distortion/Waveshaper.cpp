@@ -0,0 +1,202 @@
+#include "pedal/Waveshaper.hpp"
+#include <type_traits>
+
+const int Waveshaper::tableSize;
+constexpr float Waveshaper::tableRange;
+
+Waveshaper::Waveshaper(Curve initialCurve, Mode initialMode, int maximumBlockSize)
+  : oversampler(1, Oversampler::Filter::IIR, maximumBlockSize){
+  transfer.resize(tableSize + 2);
+  integral.resize(tableSize + 2);
+  //oversampler splits blocks at its maximum, and at most 8x that reach shape()
+  driven.resize(oversampler.getMaximumBlockSize() * 8 + 1);
+  antiderivatives.resize(oversampler.getMaximumBlockSize() * 8 + 1);
+  mode = initialMode;
+  lastInput = 0.0f;
+  setCurve(initialCurve);//also resets lastIntegral
+  setDriveDB(0.0f);
+  setOutputGainDB(0.0f);
+  currentDrive = linearDrive;
+  currentOutputGain = linearOutputGain;
+  currentSample = 0.0f;
+}
+
+float Waveshaper::process(float input){
+  processBlock(&input, &currentSample, 1);
+  return currentSample;
+}
+void Waveshaper::processBlock(const float* input, float* output, int numberOfSamples){
+  if(numberOfSamples <= 0){return;}
+  int factor = oversampler.getFactor();
+  //gain changes ramp over the whole block, at the oversampled rate
+  float driveStep = (linearDrive - currentDrive) / static_cast<float>(numberOfSamples * factor);
+  float gainStep = (linearOutputGain - currentOutputGain) / static_cast<float>(numberOfSamples * factor);
+  float drive = currentDrive;
+  float gain = currentOutputGain;
+  auto shapeBlock = [&](float* samples, int count){
+    if(mode == Mode::ADAA){
+      shape<true>(samples, count, drive, driveStep, gain, gainStep);
+    }else{
+      shape<false>(samples, count, drive, driveStep, gain, gainStep);
+    }
+    drive += driveStep * static_cast<float>(count);
+    gain += gainStep * static_cast<float>(count);
+  };
+  if(factor == 1){
+    if(input != output){std::copy(input, input + numberOfSamples, output);}
+    int maximumBlockSize = oversampler.getMaximumBlockSize();
+    for(int start = 0; start < numberOfSamples; start += maximumBlockSize){
+      shapeBlock(output + start, std::min(maximumBlockSize, numberOfSamples - start));
+    }
+  }else{
+    oversampler.process(input, output, numberOfSamples, shapeBlock);
+  }
+  currentDrive = linearDrive;
+  currentOutputGain = linearOutputGain;
+  currentSample = output[numberOfSamples - 1];
+}
+
+template<bool antiderivative>
+void Waveshaper::shape(float* samples, int numberOfSamples, float drive, float driveStep,
+                       float gain, float gainStep){
+  float* inputs = driven.data();//the last block's last input first
+  double* areas = antiderivatives.data();
+  inputs[0] = lastInput;
+  areas[0] = lastIntegral;
+  lookUp<antiderivative>(samples, inputs + 1, areas + 1, transfer.data(), integral.data(),
+                         numberOfSamples, drive, driveStep, gain, gainStep);
+  if(antiderivative){//the average of the curve from each input to the next
+    for(int i = 0; i < numberOfSamples; i++){
+      float difference = inputs[i + 1] - inputs[i];
+      float nudge = std::copysign(1.0e-8f, difference);//see bottom of header
+      float average = static_cast<float>((areas[i + 1] - areas[i] + nudge * samples[i]) /
+                                         (difference + nudge));
+      samples[i] = average * (gain + static_cast<float>(i) * gainStep);
+    }
+    lastIntegral = areas[numberOfSamples];
+  }
+  lastInput = inputs[numberOfSamples];
+}
+//__restrict promises that none of the arrays overlap, which the compiler needs
+//before it will load from the tables for several samples at once
+template<bool antiderivative>
+void Waveshaper::lookUp(float* __restrict samples, float* __restrict inputs, double* __restrict areas,
+                        const float* __restrict curveTable, const double* __restrict integralTable,
+                        int numberOfSamples, float drive, float driveStep, float gain, float gainStep){
+  //ADAA finds the position in double: in float it is only as fine as about 0.000001
+  //near 0.0, and ADAA divides by input steps much smaller than that (see bottom of header)
+  using Position = typename std::conditional<antiderivative, double, float>::type;
+  const Position range = tableRange;
+  const Position scale = static_cast<Position>(tableSize) / (2.0f * range);//table points per 1.0
+  const double spacing = 2.0 * tableRange / tableSize;
+  //no comparisons, branches, or values carried from one sample to the next:
+  //clamping is done with fabs, and the ends of the table with truncation
+  for(int i = 0; i < numberOfSamples; i++){
+    float x = samples[i] * (drive + static_cast<float>(i) * driveStep);
+    //(inputs past about a million lose their place in the table to rounding)
+    Position clamped = 0.5f * (std::fabs(x + range) - std::fabs(x - range));
+    Position position = (clamped + range) * scale;
+    int index = std::min(std::max(static_cast<int>(position), 0), tableSize);
+    Position fraction = position - static_cast<Position>(index);
+    Position slope = curveTable[index + 1] - curveTable[index];
+    Position value = curveTable[index] + fraction * slope;
+    inputs[i] = x;
+    if(antiderivative){
+      //the interpolated curve integrated exactly, continuing straight past the table
+      areas[i] = integralTable[index] +
+                 spacing * fraction * (curveTable[index] + 0.5f * fraction * slope) +
+                 value * (x - clamped);
+      samples[i] = static_cast<float>(value);//gain is applied to the average, in shape()
+    }else{
+      samples[i] = static_cast<float>(value) * (gain + static_cast<float>(i) * gainStep);
+    }
+  }
+}
+
+void Waveshaper::integrate(){
+  transfer[tableSize + 1] = transfer[tableSize];//so the last point can be interpolated
+  double spacing = 2.0 * tableRange / tableSize;
+  integral[0] = 0.0;
+  for(int i = 0; i <= tableSize; i++){//each segment is a straight line, so trapezoids are exact
+    integral[i + 1] = integral[i] + spacing * 0.5 * (transfer[i] + transfer[i + 1]);
+  }
+  //measured from 0.0 rather than -tableRange, so quiet input has small, precise areas
+  double atZero = integral[tableSize / 2];
+  for(int i = 0; i <= tableSize + 1; i++){integral[i] -= atZero;}
+  lastIntegral = antiderivativeAt(lastInput);//changes with the curve
+}
+double Waveshaper::antiderivativeAt(float x){//the same as lookUp<true>(), for one input
+  double clamped = clamp(static_cast<double>(x), -static_cast<double>(tableRange),
+                         static_cast<double>(tableRange));
+  double position = (clamped + tableRange) * tableSize / (2.0 * tableRange);
+  int index = clamp(static_cast<int>(position), 0, tableSize);
+  double fraction = position - static_cast<double>(index);
+  double slope = transfer[index + 1] - transfer[index];
+  double spacing = 2.0 * tableRange / tableSize;
+  return integral[index] + spacing * fraction * (transfer[index] + 0.5 * fraction * slope) +
+         (transfer[index] + fraction * slope) * (x - clamped);
+}
+
+void Waveshaper::reset(){
+  oversampler.reset();
+  lastInput = 0.0f;
+  integrate();
+}
+
+void Waveshaper::setCurve(Curve newCurve){
+  switch(newCurve){
+    case Curve::TANH:
+    setCustomCurve([](float x){return std::tanh(x);});
+    break;
+    case Curve::SOFT_CLIP:
+    setCustomCurve([](float x){
+      float clamped = clamp(x, -1.0f, 1.0f);
+      return 1.5f * (clamped - clamped * clamped * clamped / 3.0f);//1.0 at +-1.0, slope 1.5 at 0.0
+    });
+    break;
+    case Curve::HARD_CLIP:
+    setCustomCurve([](float x){return clamp(x, -1.0f, 1.0f);});
+    break;
+    case Curve::TUBE:
+    setCustomCurve([](float x){
+      //moved along tanh so 0.0 still gives 0.0, and scaled back to a slope of 1.0 there
+      const float bias = 0.3f;
+      float atBias = std::tanh(bias);
+      return (std::tanh(x + bias) - atBias) / (1.0f - atBias * atBias);
+    });
+    break;
+    case Curve::CUSTOM://keep the current table
+    break;
+  }
+  curve = newCurve;
+}
+void Waveshaper::setMode(Mode newMode){
+  if(newMode == Mode::ADAA && mode != Mode::ADAA){
+    lastIntegral = antiderivativeAt(lastInput);//TABLE mode only keeps the input
+  }
+  mode = newMode;
+}
+void Waveshaper::setDriveDB(float newDriveDB){
+  driveDB = newDriveDB;
+  linearDrive = dBToAmplitude(driveDB);
+}
+void Waveshaper::setOutputGainDB(float newOutputGainDB){
+  outputGainDB = newOutputGainDB;
+  linearOutputGain = dBToAmplitude(outputGainDB);
+}
+void Waveshaper::setOversampling(int newFactor){oversampler.setFactor(newFactor);}
+void Waveshaper::setOversamplingFilter(Oversampler::Filter newFilter){oversampler.setFilter(newFilter);}
+
+Waveshaper::Curve Waveshaper::getCurve(){return curve;}
+Waveshaper::Mode Waveshaper::getMode(){return mode;}
+float Waveshaper::getDriveDB(){return driveDB;}
+float Waveshaper::getOutputGainDB(){return outputGainDB;}
+int Waveshaper::getOversampling(){return oversampler.getFactor();}
+Oversampler::Filter Waveshaper::getOversamplingFilter(){return oversampler.getFilter();}
+float Waveshaper::getSample(){return currentSample;}
+float Waveshaper::getLatency(){
+  float latency = oversampler.getLatency();
+  if(mode == Mode::ADAA){latency += 0.5f / static_cast<float>(oversampler.getFactor());}
+  return latency;
+}
+int Waveshaper::getLatencyInSamples(){return static_cast<int>(getLatency() + 0.5f);}
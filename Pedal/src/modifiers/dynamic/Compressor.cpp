@@ -5,10 +5,14 @@ Compressor::Compressor(){
   setThresholdDB(-12.0f);//at what intensity should the compressor start compressing?
   setRatio(4.0f);//if over threshold by 'ratio' decibels, scale down until it's only 1/ratio decibels over threshold
   setInputGainDB(0.0f);//Raising input gain is effectively the same as lowering threshold
+  setMakeUpGainDB(0.0f);
   setAttackTime(5.0f);//experiment with very low values (0.01ms to 10ms)
   setReleaseTime(20.0f);//generall longer than attack (10 to 100ms)
   setAnalysisTime(samplesToMS(16));//analysis window size. lower values are more sensitive to input transients.
+  setLookAheadTime(0.0f);//only the analysis time is compensated by default
   highestAttackPhaseTarget = 0.0f;//keep track of highest target; only update if new target is higher
+  attackFlag = false;//start in release, at unity gain
+  attackPhaseInSamples = 0;
   linearGain.setTarget(1.0f);
 }
 float Compressor::process(float input){
@@ -30,23 +34,32 @@ float Compressor::process(float input, float sideChain){//overload for sidechain
                   linearGain.process() * linearMakeUpGain;
   return currentSample;//return the result
 }
+void Compressor::processLinked(const float* input, float* output, int numberOfFrames){
+  //the same delay as process(), rounded to whole frames
+  int delayInFrames = static_cast<int>(msToSamples(analysisTime + lookAhead) + 0.5f);
+  linked.process(input, output, numberOfFrames, delayInFrames, [this](float detected){
+    updateGain(detected * linearInputGain);
+    return linearGain.getCurrentValue() * linearMakeUpGain;
+  });
+  if(numberOfFrames > 0){currentSample = output[(numberOfFrames - 1) * linked.getNumberOfChannels()];}
+}
 void Compressor::updateGain(float input){
   //Find the linear intensity of scaled input signal
   float currentEstimate = signalEstimator.process(input);//store the estimate
   //debug.printOncePerBuffer(currentEstimate);
   if(currentEstimate > linearThreshold){//if the threshold has been exceded 
-    //This next portion is particularily expensive as it must call both
-    //amplitudeToDB and dBToAmplitude. Fortunately, this is only called
-    //every time a higher currentEstimate is reached.
+    //This next portion must convert to and from decibels. The fast
+    //approximations (FastMath.hpp) are used since this runs on the audio
+    //thread; their error is far below what can be heard.
     if(currentEstimate > highestAttackPhaseTarget){//should only occur if exceeds previous target
       attackFlag = true;//make sure compressor is in attack phase if it wasn't already
       attackPhaseInSamples = 0;//restart the attack phase
       highestAttackPhaseTarget = currentEstimate;//record it as the highest
       //how many dB past the threshold was it? How many dB over?
-      float differenceInDB = amplitudeToDB(currentEstimate) - threshold;
+      float differenceInDB = fastAmplitudeToDB(currentEstimate) - threshold;
       //how much should the signal be scaled by?
       reductionTargetDB = differenceInDB * dBDifferenceScalar;//dBDifferenceSclar = -(1.0f - (1.0f/ratio))
-      linearGain.setTarget(dBToAmplitude(reductionTargetDB));//ramp to target amplitue scalar
+      linearGain.setTarget(fastDBToAmplitude(reductionTargetDB));//ramp to target amplitue scalar
     }
   }
   if(attackFlag){//if in attack phase
@@ -82,9 +95,12 @@ void Compressor::setLookAheadTime(float newLookAheadTime){
   lookAhead = std::fmax(newLookAheadTime, 0.0f);
 }
 //lower times (8-32 samples) are more transient-sensitive
-void Compressor::setAnalysisTime(float newAnalysisTime){//defaults to 16 samples
-  signalEstimator.setSamplePeriod(samplesToMS(newAnalysisTime));
+void Compressor::setAnalysisTime(float newAnalysisTime){//(ms)
+  analysisTime = std::max(newAnalysisTime, 0.0f);
+  signalEstimator.setSamplePeriod(msToSamples(analysisTime));
 }
+void Compressor::setLinkedChannels(int numberOfChannels){linked.setNumberOfChannels(numberOfChannels);}
+void Compressor::setChannelLink(ChannelLink newChannelLink){linked.setMode(newChannelLink);}
 float Compressor::getSample(){return currentSample;}
 //getLinearScalar() may be used to compress external signals
 float Compressor::getLinearScalar(){
@@ -96,4 +112,7 @@ float Compressor::getInputGainDB(){return amplitudeToDB(linearInputGain);}
 float Compressor::getMakeUpGainDB(){return dBToAmplitude(linearMakeUpGain);}
 float Compressor::getAttackTime(){return linearGain.getTimeUp();}
 float Compressor::getReleaseTime(){return linearGain.getTimeDown();}
-float Compressor::getLookAheadTime(){return lookAhead;}
\ No newline at end of file
+float Compressor::getLookAheadTime(){return lookAhead;}
+float Compressor::getAnalysisTime(){return analysisTime;}
+int Compressor::getLinkedChannels(){return linked.getNumberOfChannels();}
+Compressor::ChannelLink Compressor::getChannelLink(){return linked.getMode();}
\ No newline at end of file
@@ -11,6 +11,10 @@ Gate::Gate(){
   setHoldTime(2.0f);//how long to hold attenuation before releasing
   setReleaseTime(20.0f);//how long to reach no attenuation
   setAnalysisTime(samplesToMS(64));//analysis window size. 
+  setLookAheadTime(0.0f);//only the analysis time is compensated by default
+  attackFlag = false;//start in release, at unity gain
+  attackPhaseInSamples = 0;
+  lowestAttackPhaseTarget = 1000.0f;//keep track of lowest target; only update if new target is lower
   linearGain.setTarget(1.0f);
 }
 float Gate::process(float input){
@@ -32,25 +36,34 @@ float Gate::process(float input, float sideChain){//overload for sidechain input
                   linearGain.getCurrentValue() * linearMakeUpGain;
   return currentSample;//return the result
 }
+void Gate::processLinked(const float* input, float* output, int numberOfFrames){
+  //the same delay as process(), rounded to whole frames
+  int delayInFrames = static_cast<int>(msToSamples(analysisTime + lookAhead) + 0.5f);
+  linked.process(input, output, numberOfFrames, delayInFrames, [this](float detected){
+    updateGain(detected * linearInputGain);
+    return linearGain.getCurrentValue() * linearMakeUpGain;
+  });
+  if(numberOfFrames > 0){currentSample = output[(numberOfFrames - 1) * linked.getNumberOfChannels()];}
+}
 void Gate::updateGain(float input){
   //Find the linear intensity of scaled input signal
   float currentEstimate = signalEstimator.process(input);//store the estimate
   //debug.printOncePerBuffer(currentEstimate);
   if(currentEstimate < linearThreshold){//if tested signal is more quite than input
-    //This next portion is particularily expensive as it must call both
-    //amplitudeToDB and dBToAmplitude. Fortunately, this is only called
-    //every time a higher currentEstimate is reached.
+    //This next portion must convert to and from decibels. The fast
+    //approximations (FastMath.hpp) are used since this runs on the audio
+    //thread; their error is far below what can be heard.
     if(currentEstimate < lowestAttackPhaseTarget){//should only occur if exceeds previous target
       lowestAttackPhaseTarget = currentEstimate;//record it as the highest
       attackFlag = true;//make sure compressor is in attack phase if it wasn't already
       attackPhaseInSamples = 0;//restart the attack phase
       //how many dB below the threshold was it? How many dB under?
       if(currentEstimate > 0.0f){//can't take amplitudeToDB of 0.0 (-inf)
-        float differenceInDB = amplitudeToDB(currentEstimate) - threshold;
+        float differenceInDB = fastAmplitudeToDB(currentEstimate) - threshold;
         //how much should the signal be scaled by?
         reductionTargetDB = (differenceInDB * (ratio)) - differenceInDB;
         reductionTargetDB -= rangeDB;//subtract rangeDB value 
-        linearGain.setTarget(dBToAmplitude(reductionTargetDB));//ramp to target amplitue scalar
+        linearGain.setTarget(fastDBToAmplitude(reductionTargetDB));//ramp to target amplitue scalar
       }else{//if estimate was 0.0f, resulting in differenceInDB being -inf
         linearGain.setTarget(0.0f);//no need to do math, just set 
       }
@@ -93,9 +106,12 @@ void Gate::setLookAheadTime(float newLookAheadTime){
   lookAhead = std::fmax(newLookAheadTime, 0.0f);
 }
 //lower times (8-32 samples) are more transient-sensitive
-void Gate::setAnalysisTime(float newAnalysisTime){//defaults to 16 samples
-  signalEstimator.setSamplePeriod(samplesToMS(newAnalysisTime));
+void Gate::setAnalysisTime(float newAnalysisTime){//(ms)
+  analysisTime = std::max(newAnalysisTime, 0.0f);
+  signalEstimator.setSamplePeriod(msToSamples(analysisTime));
 }
+void Gate::setLinkedChannels(int numberOfChannels){linked.setNumberOfChannels(numberOfChannels);}
+void Gate::setChannelLink(ChannelLink newChannelLink){linked.setMode(newChannelLink);}
 float Gate::getSample(){return currentSample;}
 //getLinearScalar() may be used to compress external signals
 float Gate::getLinearScalar(){
@@ -107,4 +123,7 @@ float Gate::getInputGainDB(){return amplitudeToDB(linearInputGain);}
 float Gate::getMakeUpGainDB(){return dBToAmplitude(linearMakeUpGain);}
 float Gate::getAttackTime(){return linearGain.getTimeUp();}
 float Gate::getReleaseTime(){return linearGain.getTimeDown();}
-float Gate::getLookAheadTime(){return lookAhead;}
\ No newline at end of file
+float Gate::getLookAheadTime(){return lookAhead;}
+float Gate::getAnalysisTime(){return analysisTime;}
+int Gate::getLinkedChannels(){return linked.getNumberOfChannels();}
+Gate::ChannelLink Gate::getChannelLink(){return linked.getMode();}
\ No newline at end of file
@@ -0,0 +1,66 @@
+#include "pedal/Limiter.hpp"
+
+Limiter::Limiter(float maximumLookAheadTime){
+  //allocate once; the look-ahead may change later without allocating
+  int maximumLookAheadInSamples = std::max(static_cast<int>(msToSamples(maximumLookAheadTime)), 1);
+  capacity = maximumLookAheadInSamples + 2;//window + 1 sample, + 1 before removal
+  delayLine.resize(capacity);
+  dequeGains.resize(capacity);
+  dequeIndices.resize(capacity);
+  averageHistory.resize(capacity);
+  linearInputGain = 1.0f;
+  lookAheadTime = maximumLookAheadTime;
+  setCeilingDB(-0.3f);//a little headroom for conversion to analog
+  setReleaseTime(50.0f);
+  setLookAheadTime(std::min(5.0f, maximumLookAheadTime));//also calls reset()
+}
+float Limiter::process(float input){
+  return processSample(input);
+}
+void Limiter::processBlock(const float* input, float* output, int numberOfSamples){
+  for(int i = 0; i < numberOfSamples; i++){
+    output[i] = processSample(input[i]);
+  }
+}
+
+void Limiter::setCeilingDB(float newCeilingDB){
+  ceilingDB = std::min(newCeilingDB, 0.0f);
+  linearCeiling = dBToAmplitude(ceilingDB);
+}
+void Limiter::setInputGainDB(float newInputGainDB){linearInputGain = dBToAmplitude(newInputGainDB);}
+void Limiter::setLookAheadTime(float newLookAheadTime){
+  lookAheadInSamples = clamp(static_cast<int>(msToSamples(newLookAheadTime)), 0, capacity - 2);
+  lookAheadTime = samplesToMS(lookAheadInSamples);
+  averageReciprocal = 1.0f / static_cast<float>(lookAheadInSamples + 1);
+  reset();//history of the old window size is no longer meaningful
+}
+void Limiter::setReleaseTime(float newReleaseTime){
+  releaseTime = std::max(newReleaseTime, 0.0f);
+  if(releaseTime > 0.0f){
+    releaseCoefficient = std::exp(-1.0f / (msToSamples(releaseTime)));
+  }else{
+    releaseCoefficient = 0.0f;
+  }
+}
+float Limiter::getSample(){return currentSample;}
+float Limiter::getLinearScalar(){return smoothedGain;}
+float Limiter::getCeilingDB(){return ceilingDB;}
+float Limiter::getInputGainDB(){return amplitudeToDB(linearInputGain);}
+float Limiter::getLookAheadTime(){return lookAheadTime;}
+float Limiter::getReleaseTime(){return releaseTime;}
+int Limiter::getLatencyInSamples(){return lookAheadInSamples;}
+
+void Limiter::reset(){
+  std::fill(delayLine.begin(), delayLine.end(), 0.0f);
+  delayWriteIndex = 0;
+  dequeFront = 0;
+  dequeSize = 0;
+  sampleIndex = 0;
+  releasedGain = 1.0f;
+  //start the moving average at unity gain (rather than fading in from 0)
+  std::fill(averageHistory.begin(), averageHistory.end(), 1.0f);
+  averageWriteIndex = 0;
+  averageTotal = lookAheadInSamples + 1;
+  smoothedGain = 1.0f;
+  currentSample = 0.0f;
+}
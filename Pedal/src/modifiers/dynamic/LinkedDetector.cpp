@@ -0,0 +1,32 @@
+#include "pedal/LinkedDetector.hpp"
+
+LinkedDetector::LinkedDetector(int numberOfChannels, float maximumDelay){
+  mode = Mode::MAXIMUM;
+  capacity = static_cast<int>(msToSamples(std::max(maximumDelay, 0.0f))) + 1;
+  setNumberOfChannels(numberOfChannels);
+}
+float LinkedDetector::detect(const float* frame){
+  if(mode == Mode::MAXIMUM){
+    float loudest = 0.0f;
+    for(int channel = 0; channel < numberOfChannels; channel++){
+      loudest = std::max(loudest, std::fabs(frame[channel]));
+    }
+    return loudest;
+  }
+  float sumOfSquares = 0.0f;
+  for(int channel = 0; channel < numberOfChannels; channel++){
+    sumOfSquares += frame[channel] * frame[channel];
+  }
+  return std::sqrt(sumOfSquares / static_cast<float>(numberOfChannels));
+}
+
+void LinkedDetector::setNumberOfChannels(int newNumberOfChannels){
+  numberOfChannels = std::max(newNumberOfChannels, 1);
+  delayLine.assign(capacity * numberOfChannels, 0.0f);
+  writeIndex = 0;
+}
+void LinkedDetector::setMode(Mode newMode){mode = newMode;}
+
+int LinkedDetector::getNumberOfChannels(){return numberOfChannels;}
+LinkedDetector::Mode LinkedDetector::getMode(){return mode;}
+int LinkedDetector::getMaximumDelayInFrames(){return capacity - 1;}
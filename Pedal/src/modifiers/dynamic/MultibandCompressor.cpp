@@ -0,0 +1,144 @@
+#include "pedal/MultibandCompressor.hpp"
+
+MultibandCompressor::MultibandCompressor(float maximumLookAheadTime){
+  //one slot more than the longest delay, so the newest frame never overwrites the oldest
+  delayCapacity = std::max(static_cast<int>(msToSamples(maximumLookAheadTime)), 0) + 1;
+  delayLine.assign(delayCapacity * numberOfBands, 0.0f);
+  delayWriteIndex = 0;
+  setLookAheadTime(std::min(5.0f, maximumLookAheadTime));
+  setInputGainDB(0.0f);
+  setAnalysisTime(samplesToMS(16));//same default as Compressor
+  //common crossover points for mastering
+  setCrossoverFrequency(0, 120.0f);
+  setCrossoverFrequency(1, 1000.0f);
+  setCrossoverFrequency(2, 6000.0f);
+  for(int b = 0; b < numberOfBands; b++){
+    setThresholdDB(b, -12.0f);
+    setRatio(b, 4.0f);
+    setAttackTime(b, 5.0f);
+    setReleaseTime(b, 50.0f);
+    setMakeUpGainDB(b, 0.0f);
+    bandSample[b] = 0.0f;
+    bandOutput[b] = 0.0f;
+    meanSquare[b] = 0.0f;
+    gainDB[b] = 0.0f;
+  }
+  updateGains();
+  currentSample = 0.0f;
+}
+float MultibandCompressor::process(float input){
+  return processSample(input);
+}
+void MultibandCompressor::processBlock(const float* input, float* output, int numberOfSamples){
+  for(int i = 0; i < numberOfSamples; i++){
+    output[i] = processSample(input[i]);
+  }
+}
+void MultibandCompressor::splitIntoBands(float input){
+  //first split, at the middle crossover
+  float low = middleLowPass[1].processSample(middleLowPass[0].processSample(input));
+  float high = middleHighPass[1].processSample(middleHighPass[0].processSample(input));
+  //match the phase shift the other half is about to receive
+  low = lowAllPass.processSample(low);
+  high = highAllPass.processSample(high);
+  //second splits
+  bandSample[0] = lowLowPass[1].processSample(lowLowPass[0].processSample(low));
+  bandSample[1] = lowHighPass[1].processSample(lowHighPass[0].processSample(low));
+  bandSample[2] = highLowPass[1].processSample(highLowPass[0].processSample(high));
+  bandSample[3] = highHighPass[1].processSample(highHighPass[0].processSample(high));
+}
+void MultibandCompressor::updateGains(){
+  //Every loop below has a fixed length and no branches, so each may
+  //become a single SIMD instruction sequence for all four bands
+  float levelDB[numberOfBands];
+  for(int b = 0; b < numberOfBands; b++){//mean square detector
+    float squared = bandSample[b] * bandSample[b];
+    meanSquare[b] = squared + (meanSquare[b] - squared) * analysisCoefficient;
+    levelDB[b] = fastPowerToDB(meanSquare[b] + 1.0e-20f);//avoid log(0)
+  }
+  for(int b = 0; b < numberOfBands; b++){//static curve, then attack/release
+    float overDB = levelDB[b] - thresholdDB[b];
+    float targetDB = overDB > 0.0f ? overDB * slope[b] : 0.0f;
+    //lower target means more reduction, which is the attack
+    float coefficient = targetDB < gainDB[b] ? attackCoefficient[b] : releaseCoefficient[b];
+    gainDB[b] = targetDB + (gainDB[b] - targetDB) * coefficient;
+  }
+  for(int b = 0; b < numberOfBands; b++){
+    linearGain[b] = fastDBToAmplitude(gainDB[b] + makeUpGainDB[b]);
+  }
+}
+float MultibandCompressor::calculateCoefficient(float timeInMS){
+  //one pole smoothing coefficient; 0 means no smoothing
+  float timeInSamples = msToSamples(timeInMS);
+  return timeInSamples > 0.0f ? std::exp(-1.0f / timeInSamples) : 0.0f;
+}
+
+//Getters and Setters===============================
+void MultibandCompressor::setCrossoverFrequency(int whichCrossover, float newFrequency){
+  whichCrossover = clamp(whichCrossover, 0, numberOfBands - 2);
+  newFrequency = clamp(newFrequency, 10.0f, pdlSettings::sampleRate * 0.45f);
+  crossoverFrequencies[whichCrossover] = newFrequency;
+  const float butterworthQ = 0.70710678f;
+  switch(whichCrossover){
+    case 0://low crossover, splits the low half. Also compensates the high half
+    for(int i = 0; i < 2; i++){
+      lowLowPass[i].setBiquad(LOW_PASS, newFrequency, butterworthQ, 0.0f);
+      lowHighPass[i].setBiquad(HIGH_PASS, newFrequency, butterworthQ, 0.0f);
+    }
+    highAllPass.setBiquad(ALL_PASS, newFrequency, butterworthQ, 0.0f);
+    break;
+    case 1://middle crossover, the first split
+    for(int i = 0; i < 2; i++){
+      middleLowPass[i].setBiquad(LOW_PASS, newFrequency, butterworthQ, 0.0f);
+      middleHighPass[i].setBiquad(HIGH_PASS, newFrequency, butterworthQ, 0.0f);
+    }
+    break;
+    case 2://high crossover, splits the high half. Also compensates the low half
+    for(int i = 0; i < 2; i++){
+      highLowPass[i].setBiquad(LOW_PASS, newFrequency, butterworthQ, 0.0f);
+      highHighPass[i].setBiquad(HIGH_PASS, newFrequency, butterworthQ, 0.0f);
+    }
+    lowAllPass.setBiquad(ALL_PASS, newFrequency, butterworthQ, 0.0f);
+    break;
+  }
+}
+void MultibandCompressor::setThresholdDB(int whichBand, float newThresholdDB){
+  thresholdDB[whichBand] = newThresholdDB;
+}
+void MultibandCompressor::setRatio(int whichBand, float newRatio){
+  ratio[whichBand] = std::max(newRatio, 1.0f);
+  slope[whichBand] = (1.0f / ratio[whichBand]) - 1.0f;
+}
+void MultibandCompressor::setAttackTime(int whichBand, float newAttackTime){
+  attackTime[whichBand] = std::max(newAttackTime, 0.0f);
+  attackCoefficient[whichBand] = calculateCoefficient(attackTime[whichBand]);
+}
+void MultibandCompressor::setReleaseTime(int whichBand, float newReleaseTime){
+  releaseTime[whichBand] = std::max(newReleaseTime, 0.0f);
+  releaseCoefficient[whichBand] = calculateCoefficient(releaseTime[whichBand]);
+}
+void MultibandCompressor::setMakeUpGainDB(int whichBand, float newMakeUpGainDB){
+  makeUpGainDB[whichBand] = newMakeUpGainDB;
+}
+void MultibandCompressor::setInputGainDB(float newInputGainDB){
+  linearInputGain = dBToAmplitude(newInputGainDB);
+}
+void MultibandCompressor::setAnalysisTime(float newAnalysisTime){
+  analysisTime = std::max(newAnalysisTime, 0.0f);
+  analysisCoefficient = calculateCoefficient(analysisTime);
+}
+void MultibandCompressor::setLookAheadTime(float newLookAheadTime){
+  lookAheadInSamples = clamp(static_cast<int>(msToSamples(newLookAheadTime)), 0, delayCapacity - 1);
+}
+float MultibandCompressor::getSample(){return currentSample;}
+float MultibandCompressor::getBandSample(int whichBand){return bandOutput[whichBand];}
+float MultibandCompressor::getLinearScalar(int whichBand){return linearGain[whichBand];}
+float MultibandCompressor::getCrossoverFrequency(int whichCrossover){return crossoverFrequencies[whichCrossover];}
+float MultibandCompressor::getThresholdDB(int whichBand){return thresholdDB[whichBand];}
+float MultibandCompressor::getRatio(int whichBand){return ratio[whichBand];}
+float MultibandCompressor::getAttackTime(int whichBand){return attackTime[whichBand];}
+float MultibandCompressor::getReleaseTime(int whichBand){return releaseTime[whichBand];}
+float MultibandCompressor::getMakeUpGainDB(int whichBand){return makeUpGainDB[whichBand];}
+float MultibandCompressor::getInputGainDB(){return amplitudeToDB(linearInputGain);}
+float MultibandCompressor::getAnalysisTime(){return analysisTime;}
+float MultibandCompressor::getLookAheadTime(){return samplesToMS(lookAheadInSamples);}
@@ -11,6 +11,7 @@ Biquad::Biquad(FilterType initialMode, float initialFrequency, float initialQ){
   mode = initialMode;
   q = initialQ;
   gain = 0.0f;
+  flush();//start with silent history
   calculateCoefficients();
 }
 Biquad::~Biquad(){
@@ -129,6 +130,14 @@ void Biquad::calculateCoefficients(){
     }
     }
     break; 
+    case ALL_PASS://feed-forward coefficients are the feed-back coefficients reversed
+    norm = 1.0 / (1.0 + kdivbyq + k_squared);
+    a0 = (1.0 - kdivbyq + k_squared) * norm;
+    a1 = 2.0 * (k_squared - 1.0) * norm;
+    a2 = 1.0;
+    b1 = a1;
+    b2 = a0;
+    break;
   }
 }
 void Biquad::flush(){
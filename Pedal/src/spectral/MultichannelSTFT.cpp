@@ -0,0 +1,137 @@
+#include "pedal/MultichannelSTFT.hpp"
+
+//Constructors and Deconstructors=============
+MultichannelSTFT::MultichannelSTFT(int initialNumberOfChannels, int initialWindowSize,
+                                   int initialOverlap, int numberOfThreads){
+  numberOfChannels = std::max(initialNumberOfChannels, 1);
+  for(int i = 0; i < numberOfChannels; i++){
+    channels.emplace_back(new STFT(initialWindowSize, initialOverlap));
+  }
+  windowSize = channels[0]->getWindowSize();//may have been rounded to a power of 2
+  hopSize = channels[0]->getHopSize();
+  inputHistory.assign(numberOfChannels, std::vector<float>(windowSize * 2, 0.0f));
+  inputWritePosition = 0;
+  samplesUntilHop = hopSize;
+  fftReadyFlag = false;
+
+  taskGeneration = 0;
+  shutdown = false;
+  currentTask = Task::ANALYSIS;
+  nextChannel = numberOfChannels;//nothing to claim yet
+  channelsFinished = numberOfChannels;
+  if(numberOfThreads <= 0){
+    numberOfThreads = static_cast<int>(std::thread::hardware_concurrency());
+  }
+  //no reason to have more threads than channels
+  numberOfThreads = clamp(numberOfThreads, 1, numberOfChannels);
+  for(int i = 1; i < numberOfThreads; i++){//the calling thread is the first thread
+    workers.emplace_back(&MultichannelSTFT::workerLoop, this);
+  }
+}
+MultichannelSTFT::~MultichannelSTFT(){
+  {
+    std::lock_guard<std::mutex> lock(taskMutex);
+    shutdown = true;
+  }
+  taskAvailable.notify_all();
+  for(auto& worker : workers){
+    worker.join();
+  }
+}
+
+//Core functionality===========================
+bool MultichannelSTFT::updateInput(const float* inputFrame){
+  //each sample is written twice, 'windowSize' apart, so the newest
+  //'windowSize' samples are always in order at &inputHistory[c][inputWritePosition]
+  for(int c = 0; c < numberOfChannels; c++){
+    inputHistory[c][inputWritePosition] = inputFrame[c];
+    inputHistory[c][inputWritePosition + windowSize] = inputFrame[c];
+  }
+  inputWritePosition = (inputWritePosition + 1) % windowSize;
+  samplesUntilHop--;
+  if(samplesUntilHop == 0){//every channel has a new frame
+    samplesUntilHop = hopSize;
+    runTask(Task::ANALYSIS);
+    fftReadyFlag = true;
+  }else{
+    fftReadyFlag = false;
+  }
+  return fftReadyFlag;
+}
+bool MultichannelSTFT::isFFTReady(){return fftReadyFlag;}
+void MultichannelSTFT::updateOutput(float* outputFrame){
+  if(fftReadyFlag){//resynthesize every channel before overlap-adding
+    runTask(Task::SYNTHESIS);
+    fftReadyFlag = false;
+  }
+  for(int c = 0; c < numberOfChannels; c++){
+    outputFrame[c] = channels[c]->updateOutput();//overlap-add only
+  }
+}
+
+//Getters and Setters===============================
+STFT& MultichannelSTFT::getChannel(int whichChannel){return *channels[whichChannel];}
+int MultichannelSTFT::getNumberOfChannels(){return numberOfChannels;}
+int MultichannelSTFT::getNumberOfThreads(){return static_cast<int>(workers.size()) + 1;}
+int MultichannelSTFT::getWindowSize(){return windowSize;}
+int MultichannelSTFT::getOverlap(){return channels[0]->getOverlap();}
+int MultichannelSTFT::getHopSize(){return hopSize;}
+
+//Private functions=================================
+void MultichannelSTFT::runTask(Task newTask){
+  if(workers.empty()){//single threaded, no need for coordination
+    for(int c = 0; c < numberOfChannels; c++){
+      if(newTask == Task::ANALYSIS){
+        channels[c]->analyzeFrame(&inputHistory[c][inputWritePosition]);
+      }else{
+        channels[c]->synthesizeFrame();
+      }
+    }
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(taskMutex);
+    currentTask = newTask;
+    channelsFinished = 0;
+    nextChannel = 0;//channels may now be claimed
+    taskGeneration++;
+  }
+  taskAvailable.notify_all();
+  processChannels();//the calling thread works too
+  while(channelsFinished.load(std::memory_order_acquire) < numberOfChannels){
+    std::this_thread::yield();//wait for the workers to finish their last channels
+  }
+}
+void MultichannelSTFT::processChannels(){
+  while(true){
+    int c = nextChannel.fetch_add(1);//claim a channel
+    if(c >= numberOfChannels){break;}//every channel has been claimed
+    if(currentTask == Task::ANALYSIS){
+      channels[c]->analyzeFrame(&inputHistory[c][inputWritePosition]);
+    }else{
+      channels[c]->synthesizeFrame();
+    }
+    channelsFinished.fetch_add(1, std::memory_order_release);
+  }
+}
+void MultichannelSTFT::workerLoop(){
+  unsigned lastGeneration = 0;
+  while(true){
+    {
+      std::unique_lock<std::mutex> lock(taskMutex);
+      taskAvailable.wait(lock, [&]{return shutdown || taskGeneration != lastGeneration;});
+      if(shutdown){return;}
+      lastGeneration = taskGeneration;
+    }
+    processChannels();
+  }
+}
+/*
+The input history is the same method STFT uses for its own input (see
+docs/STFT.md). Writing each sample twice costs one extra write per
+sample but means the analysis never has to wrap around the end of an
+array; each channel's frame is one contiguous block of memory.
+
+A worker which wakes late (after every channel has been claimed) finds
+nothing left to claim and goes back to sleep; this is harmless.
+*/
@@ -0,0 +1,210 @@
+#include "pedal/PhaseVocoder.hpp"
+
+//wrap a phase to the range -pi to pi
+static inline float wrapPhase(float phase){
+  float turns = phase * 0.15915494309f;//phase / 2pi
+  turns += turns >= 0.0f ? 0.5f : -0.5f;//round away from 0 when truncated
+  return phase - static_cast<float>(static_cast<int>(turns)) * 6.28318530718f;
+}
+
+//Constructors and Deconstructors=============
+PhaseVocoder::PhaseVocoder(int initialWindowSize, int initialOverlap)
+: stft(initialWindowSize, initialOverlap){
+  bufferReference = nullptr;
+  pitchRatio = 1.0f;
+  timeRatio = 1.0f;
+  phaseLocking = true;
+  playPosition = 0.0;
+  currentSample = 0.0f;
+  allocateFrames();
+}
+
+//Core functionality===========================
+float PhaseVocoder::processSample(float input){
+  if(stft.updateInput(input)){//a new frame has been analyzed
+    processFrame(stft.getHopSize());//live input is analyzed every hop
+  }
+  currentSample = stft.updateOutput() * outputGain;
+  return currentSample;
+}
+float PhaseVocoder::generateSample(){
+  //can't play nothing (an empty buffer has no position to wrap around)
+  if(bufferReference == nullptr || bufferReference->getDurationInSamples() == 0){
+    currentSample = 0.0f;
+    return currentSample;
+  }
+  if(sampleCounter == 0){//time for a new frame
+    long frameStart = static_cast<long>(playPosition);
+    long bufferLength = static_cast<long>(bufferReference->getDurationInSamples());
+    //the real distance since the last frame (frame positions are whole samples)
+    long analysisHop = frameStart - previousFrameStart;
+    if(analysisHop < 0){//the play position has wrapped around the buffer
+      analysisHop += bufferLength;
+    }
+    previousFrameStart = frameStart;
+    fillFrameFromBuffer(frameStart);
+    stft.analyzeFrame(bufferFrame.data());
+    processFrame(static_cast<int>(analysisHop));
+    //a time ratio of 2 analyzes frames half as far apart as they are resynthesized
+    playPosition += stft.getHopSize() / timeRatio;
+    if(playPosition >= bufferLength){
+      playPosition -= bufferLength;
+    }
+  }
+  sampleCounter = (sampleCounter + 1) % stft.getHopSize();
+  currentSample = stft.updateOutput() * outputGain;
+  return currentSample;
+}
+
+//Getters and Setters===============================
+void PhaseVocoder::setPitchRatio(float newPitchRatio){
+  pitchRatio = std::max(newPitchRatio, 0.0f);
+}
+void PhaseVocoder::setTimeRatio(float newTimeRatio){
+  timeRatio = std::max(newTimeRatio, 0.001f);//avoid / 0
+}
+void PhaseVocoder::setPhaseLocking(bool newPhaseLocking){phaseLocking = newPhaseLocking;}
+void PhaseVocoder::setBuffer(Buffer* newBuffer){
+  bufferReference = newBuffer;
+  setPlayPosition(0.0f);
+}
+void PhaseVocoder::setPlayPosition(float newPositionInSamples){
+  playPosition = std::max(newPositionInSamples, 0.0f);
+  previousFrameStart = static_cast<long>(playPosition) - stft.getHopSize();
+}
+void PhaseVocoder::setWindowType(Window::Mode newWindowType){
+  stft.setWindowType(newWindowType);
+  outputGain = 1.0f / stft.getOverlapAddGain();
+}
+void PhaseVocoder::setWindowSize(int powerOfTwoSize){
+  stft.setWindowSize(powerOfTwoSize);
+  allocateFrames();
+}
+void PhaseVocoder::setOverlap(int newOverlap){
+  stft.setOverlap(newOverlap);
+  allocateFrames();
+}
+float PhaseVocoder::getPitchRatio(){return pitchRatio;}
+float PhaseVocoder::getTimeRatio(){return timeRatio;}
+bool PhaseVocoder::getPhaseLocking(){return phaseLocking;}
+float PhaseVocoder::getPlayPosition(){return static_cast<float>(playPosition);}
+int PhaseVocoder::getWindowSize(){return stft.getWindowSize();}
+int PhaseVocoder::getOverlap(){return stft.getOverlap();}
+float PhaseVocoder::getCurrentSample(){return currentSample;}
+
+//Private functions=================================
+void PhaseVocoder::allocateFrames(){
+  int numberOfBins = stft.getNumberOfBins() + 1;//include the nyquist bin
+  //assign (rather than resize) so every value starts at 0
+  analysisMagnitudes.assign(numberOfBins, 0.0f);
+  analysisPhases.assign(numberOfBins, 0.0f);
+  previousAnalysisPhases.assign(numberOfBins, 0.0f);
+  binFrequencies.assign(numberOfBins, 0.0f);
+  synthesisMagnitudes.assign(numberOfBins, 0.0f);
+  synthesisFrequencies.assign(numberOfBins, 0.0f);
+  synthesisPhases.assign(numberOfBins, 0.0f);
+  outputPhases.assign(numberOfBins, 0.0f);
+  sourceBin.assign(numberOfBins, 0);
+  nearestPeak.assign(numberOfBins, 0);
+  bufferFrame.assign(stft.getWindowSize(), 0.0f);
+  outputGain = 1.0f / stft.getOverlapAddGain();
+  sampleCounter = 0;
+  setPlayPosition(static_cast<float>(playPosition));
+}
+void PhaseVocoder::processFrame(int analysisHop){
+  const int numberOfBins = static_cast<int>(analysisMagnitudes.size());
+  const float windowSize = static_cast<float>(stft.getWindowSize());
+  const float twoPi = 6.28318530718f;
+  stft.computeMagnitudes(analysisMagnitudes.data());
+  stft.computePhases(analysisPhases.data());
+
+  //1) instantaneous frequency of each analysis bin
+  //a sinusoid centered on bin k advances 2pi * k * hop / windowSize per frame.
+  //The remaining (wrapped) phase difference is the offset from bin center.
+  if(analysisHop > 0){
+    const float expectedAdvance = twoPi * analysisHop / windowSize;
+    const float deviationToBins = windowSize / (twoPi * analysisHop);
+    for(int k = 0; k < numberOfBins; k++){
+      float deviation = analysisPhases[k] - previousAnalysisPhases[k] - k * expectedAdvance;
+      binFrequencies[k] = k + wrapPhase(deviation) * deviationToBins;
+    }
+  }else{//no time has passed; the best guess is the bin center
+    for(int k = 0; k < numberOfBins; k++){
+      binFrequencies[k] = static_cast<float>(k);
+    }
+  }
+  for(int k = 0; k < numberOfBins; k++){
+    previousAnalysisPhases[k] = analysisPhases[k];
+  }
+
+  //2) move each analysis bin to its pitch shifted synthesis bin
+  for(int k = 0; k < numberOfBins; k++){
+    synthesisMagnitudes[k] = 0.0f;
+    synthesisFrequencies[k] = static_cast<float>(k);
+    sourceBin[k] = k;
+  }
+  for(int k = 0; k < numberOfBins; k++){
+    int target = static_cast<int>(k * pitchRatio + 0.5f);
+    if(target >= numberOfBins){break;}//everything above is out of range
+    //when several bins land on one, the loudest decides the frequency
+    if(synthesisMagnitudes[target] == 0.0f ||
+       analysisMagnitudes[k] > analysisMagnitudes[sourceBin[target]]){
+      synthesisFrequencies[target] = binFrequencies[k] * pitchRatio;
+      sourceBin[target] = k;
+    }
+    synthesisMagnitudes[target] += analysisMagnitudes[k];
+  }
+
+  //3) advance every synthesis phase by its frequency over one output hop
+  const float synthesisAdvance = twoPi * stft.getHopSize() / windowSize;
+  for(int k = 0; k < numberOfBins; k++){
+    synthesisPhases[k] = wrapPhase(synthesisPhases[k] +
+                                   synthesisFrequencies[k] * synthesisAdvance);
+    outputPhases[k] = synthesisPhases[k];
+  }
+
+  //4) identity phase locking: bins keep their analysis phase relationship
+  //to the peak which owns them
+  if(phaseLocking){
+    //forward pass: remember the closest peak on the left
+    int leftPeak = -1;
+    for(int k = 0; k < numberOfBins; k++){
+      float magnitude = synthesisMagnitudes[k];
+      bool aboveLeft = k == 0 || magnitude > synthesisMagnitudes[k - 1];
+      bool aboveRight = k == numberOfBins - 1 || magnitude >= synthesisMagnitudes[k + 1];
+      if(aboveLeft && aboveRight && magnitude > 0.0f){
+        leftPeak = k;
+      }
+      nearestPeak[k] = leftPeak;
+    }
+    //backward pass: choose the closer of the left and right peaks
+    int rightPeak = -1;
+    for(int k = numberOfBins - 1; k >= 0; k--){
+      if(nearestPeak[k] == k){//this bin is a peak
+        rightPeak = k;
+        continue;
+      }
+      int peak = nearestPeak[k];
+      if(rightPeak >= 0 && (peak < 0 || rightPeak - k < k - peak)){
+        peak = rightPeak;
+      }
+      if(peak >= 0){
+        outputPhases[k] = synthesisPhases[peak] +
+                          analysisPhases[sourceBin[k]] - analysisPhases[sourceBin[peak]];
+      }
+    }
+  }
+  stft.setFromPolar(synthesisMagnitudes.data(), outputPhases.data());
+}
+void PhaseVocoder::fillFrameFromBuffer(long startSample){
+  const float* content = bufferReference->getContent();
+  const long bufferLength = static_cast<long>(bufferReference->getDurationInSamples());
+  const int numberChannels = bufferReference->getNumberChannels();
+  const int windowSize = stft.getWindowSize();
+  long readIndex = startSample % bufferLength;
+  for(int i = 0; i < windowSize; i++){//only the first channel is used
+    bufferFrame[i] = content[readIndex * numberChannels];
+    readIndex++;
+    if(readIndex >= bufferLength){readIndex = 0;}//loop the buffer
+  }
+}
@@ -2,14 +2,9 @@
 
 STFT::STFT(int initialWindowSize, int initialOverlap){
   overlap = initialOverlap;
-  setWindowType(Window::Mode::HANNING);
-  setWindowSize(initialWindowSize);
-  fft.init(windowSize);
-  hopSize = windowSize / overlap;
+  windowType = Window::Mode::HANNING;//assign directly, window is not allocated yet
+  setWindowSize(initialWindowSize);//allocates and calculates the window
   fftReadyFlag = false;
-  inputWritePosition = 0;
-  inputWriteRedundantPosition = inputWritePosition + windowSize;
-  currentOutputIndex = 0;
   currentSample = 0.0f;//not used unless inversing
 }
 bool STFT::updateInput(float input){
@@ -33,27 +28,49 @@ bool STFT::updateInput(float input){
   }
   return fftReadyFlag;
 }
+//Analyze a frame supplied by the user instead of the input stream.
+//This allows the analysis position to move at a different rate than
+//the output (as in time stretching). Call once every 'hopSize' samples,
+//before updateOutput()
+bool STFT::analyzeFrame(const float* frame){
+  for(int i = 0; i < windowSize; i++){
+    windowedInputSegment[i] = frame[i] * window[i];
+  }
+  fft.fft(windowedInputSegment.data(), realBuffer.data(), imaginaryBuffer.data());
+  fftReadyFlag = true;
+  return fftReadyFlag;
+}
 bool STFT::isFFTReady(){
   return fftReadyFlag;
 }
-float STFT::updateOutput(){//MUST be called per sample if at all
-  currentOutputIndex = currentOutputIndex % windowSize;//wrap output index
+//inverse FFT and window the ready frame into its overlap layer.
+//updateOutput() calls this when needed; it is public so the work can
+//be done ahead of time (or on another thread) before updateOutput()
+void STFT::synthesizeFrame(){
   if(fftReadyFlag){//segment is ready to be ifftd and windowed
     whichOutputLayer = currentOutputIndex / hopSize;
+    //frames may arrive part way through a hop (live input arrives 'hopSize - 1'
+    //samples into it). Remember this so each layer is read from its first sample
+    outputAlignment = currentOutputIndex % hopSize;
     //deliver resynthesis to windowedOutput[whichOutputLayer]    
     fft.ifft(windowedOutput[whichOutputLayer].data(), realBuffer.data(), imaginaryBuffer.data());
     //window those samples in place
     for(int i = 0; i < windowSize; i++){
       windowedOutput[whichOutputLayer][i] *= window[i];
     }
+    fftReadyFlag = false;//this frame has been consumed
   }
+}
+float STFT::updateOutput(){//MUST be called per sample if at all
+  synthesizeFrame();//only does work if a frame is ready
   currentSample = 0.0f;//reset currentSample from last round
   for(int i = 0; i < overlap; i++){//for every overlap layer
     //for each itteration, look back an additional 'hopSize' samples
-    int index = (currentOutputIndex - (hopSize * i) + windowSize) % windowSize;//add
+    int index = (currentOutputIndex - outputAlignment - (hopSize * i) + windowSize) % windowSize;//add
     currentSample += windowedOutput[i][index];
   }
   currentOutputIndex++;//increment output buffer index
+  currentOutputIndex = currentOutputIndex % windowSize;//wrap output index
   return currentSample;//return single sample
 }
 //------------------------------Set/Get
@@ -84,18 +101,24 @@ void STFT::setOverlap(int newOverlap){
     }
   }
   overlap = newOverlap;//assign the new overlap value
+  hopSize = windowSize / overlap;
 }
 void STFT::setWindowSize(int powerOfTwoSize){
   //round up to nearest power of 2
   //from stack overflow:https://stackoverflow.com/questions/466204/rounding-up-to-next-power-of-2
   windowSize = std::pow(2, std::ceil(std::log(powerOfTwoSize)/
                                      std::log(2.0f)));
+  hopSize = windowSize / overlap;
+  fft.init(windowSize);//only (re)calculates if the size has changed
+  inputWritePosition = 0;
+  inputWriteRedundantPosition = windowSize;
+  currentOutputIndex = 0;
+  outputAlignment = 0;
   inputBuffer.resize(windowSize * 2, 0.0f);//*see notes at bottom
   windowedInputSegment.resize(windowSize);
   int complexSize = (windowSize/2) + 1;//real and imaginary buffer need half windowsize + 1
   realBuffer.resize(complexSize);
   imaginaryBuffer.resize(complexSize);
-  window.resize(windowSize);
   windowedOutput.resize(overlap);
   windowedOutput.clear();
   std::vector<float> temp(windowSize, 0.0f);
@@ -108,7 +131,7 @@ void STFT::setWindowSize(int powerOfTwoSize){
 //user is responsible for not asking for a bin that doesn't exist(which bin shouldn't be > windowSize-1)
 void STFT::setBin(int whichBin, std::complex<float> complexInput){
   realBuffer[whichBin] = complexInput.real();
-  imaginaryBuffer[whichBin] = complexInput.real();
+  imaginaryBuffer[whichBin] = complexInput.imag();
 }
 void STFT::setBinMagnitude(int whichBin, float newMagnitude){
   std::complex<float> bin = {realBuffer[whichBin], imaginaryBuffer[whichBin]};
@@ -133,6 +156,10 @@ int STFT::getWindowSize(){return windowSize;}
 int STFT::getOverlap(){return overlap;}
 int STFT::getHopSize(){return hopSize;}
 int STFT::getNumberOfBins(){return windowSize/2;}
+float STFT::getOverlapAddGain(){
+  //each output sample is the sum of 'overlap' layers, each scaled by the window twice
+  return windowTable->getOverlapAddGain(hopSize, true);
+}
 std::complex<float> STFT::getBin(int whichBin){//git bin's real and imaginary components
   std::complex<float> bin;//temporary bin 
   //assign from calculated fft
@@ -159,47 +186,53 @@ float* STFT::getRealBufferPointer(){
 float* STFT::getImaginaryBufferPointer(){
   return imaginaryBuffer.data();
 }
+//------------------------Whole-frame functions
+//Each loop below is free of branches and function calls so the compiler
+//can process several bins at once (see FastMath.hpp)
+void STFT::computeMagnitudes(float* magnitudeOutput){
+  const int numberOfBins = static_cast<int>(realBuffer.size());
+  const float* real = realBuffer.data();
+  const float* imaginary = imaginaryBuffer.data();
+  for(int i = 0; i < numberOfBins; i++){
+    magnitudeOutput[i] = std::sqrt(real[i] * real[i] + imaginary[i] * imaginary[i]);
+  }
+}
+void STFT::computePhases(float* phaseOutput){
+  const int numberOfBins = static_cast<int>(realBuffer.size());
+  const float* real = realBuffer.data();
+  const float* imaginary = imaginaryBuffer.data();
+  for(int i = 0; i < numberOfBins; i++){
+    phaseOutput[i] = fastAtan2(imaginary[i], real[i]);
+  }
+}
+void STFT::setFromPolar(const float* magnitudes, const float* phases){
+  const int numberOfBins = static_cast<int>(realBuffer.size());
+  float* real = realBuffer.data();
+  float* imaginary = imaginaryBuffer.data();
+  for(int i = 0; i < numberOfBins; i++){
+    real[i] = magnitudes[i] * fastCos(phases[i]);
+    imaginary[i] = magnitudes[i] * fastSin(phases[i]);
+  }
+}
+//user is responsible for both STFTs having the same window size
+void STFT::multiplySpectrum(const STFT& other){
+  const int numberOfBins = static_cast<int>(realBuffer.size());
+  float* real = realBuffer.data();
+  float* imaginary = imaginaryBuffer.data();
+  const float* otherReal = other.realBuffer.data();
+  const float* otherImaginary = other.imaginaryBuffer.data();
+  for(int i = 0; i < numberOfBins; i++){
+    //(a + bi)(c + di) = (ac - bd) + (ad + bc)i
+    float newReal = real[i] * otherReal[i] - imaginary[i] * otherImaginary[i];
+    float newImaginary = real[i] * otherImaginary[i] + imaginary[i] * otherReal[i];
+    real[i] = newReal;
+    imaginary[i] = newImaginary;
+  }
+}
 //------------------------Private functions
 void STFT::calculateWindow(){
-  //calculate once since used 'windowSize' times
-  float phaseReciprocal = 1.0f/static_cast<float>(windowSize - 1);
-  switch(windowType){//fill 'window' vector based on window type
-    case Window::Mode::HANNING:
-      for(int i = 0; i < windowSize; i++){
-        float phase = i * phaseReciprocal;
-        window[i] = Window::hanningFromPhase(phase);
-      }
-    break;
-    case Window::Mode::HAMMING:
-      for(int i = 0; i < windowSize; i++){
-        float phase = i * phaseReciprocal;
-        window[i] = Window::hammingFromPhase(phase);
-      }
-    break;
-    case Window::Mode::COSINE:
-      for(int i = 0; i < windowSize; i++){
-        float phase = i * phaseReciprocal;
-        window[i] = Window::cosineFromPhase(phase);
-      }
-    break;
-    case Window::Mode::TRIANGULAR:
-      for(int i = 0; i < windowSize; i++){
-        float phase = i * phaseReciprocal;
-        window[i] = Window::triangularFromPhase(phase);
-      }
-    break;
-    case Window::Mode::BLACKMAN_NUTALL:
-      for(int i = 0; i < windowSize; i++){
-        float phase = i * phaseReciprocal;
-        window[i] = Window::blackmanNutallFromPhase(phase);
-      }
-    break;
-    case Window::Mode::GAUSSIAN:
-      for(int i = 0; i < windowSize; i++){
-        float phase = i * phaseReciprocal;
-        window[i] = Window::gaussianFromPhase(phase);
-      }
-    break;
-  }
+  //periodic, so the overlapping windows sum to a constant (see WindowTable)
+  windowTable = WindowTable::get(windowType, windowSize);
+  window = windowTable->data();
 }
 // calculateWindowedInput() is in header b/c inlined
\ No newline at end of file
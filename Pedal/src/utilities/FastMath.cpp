@@ -0,0 +1,26 @@
+#include "pedal/FastMath.hpp"
+
+//single value versions are in header b/c inlined
+void fastAmplitudeToDB(const float* amplitudes, float* dBOutput, int size){
+  for(int i = 0; i < size; i++){
+    dBOutput[i] = fastAmplitudeToDB(amplitudes[i]);
+  }
+}
+void fastDBToAmplitude(const float* dBs, float* amplitudeOutput, int size){
+  for(int i = 0; i < size; i++){
+    amplitudeOutput[i] = fastDBToAmplitude(dBs[i]);
+  }
+}
+void fastSinCycles(const float* cycles, float* output, int size, SineAccuracy accuracy){
+  switch(accuracy){//chosen once, so each loop is a single polynomial
+    case SineAccuracy::LOW:
+    for(int i = 0; i < size; i++){output[i] = fastSinCycles<SineAccuracy::LOW>(cycles[i]);}
+    break;
+    case SineAccuracy::MEDIUM:
+    for(int i = 0; i < size; i++){output[i] = fastSinCycles<SineAccuracy::MEDIUM>(cycles[i]);}
+    break;
+    case SineAccuracy::HIGH:
+    for(int i = 0; i < size; i++){output[i] = fastSinCycles<SineAccuracy::HIGH>(cycles[i]);}
+    break;
+  }
+}
@@ -4,10 +4,10 @@
 float cubicInterpolation(float inputSample, float backTwo, float backOne, 
                          float forwardOne, float forwardTwo){
     float x = inputSample - int(inputSample);//position between samples
-    float a = -0.5*backTwo + 1.5*backOne - 1.5*forwardOne + 0.5 * forwardTwo;
-    float b = backTwo - 2.5*backOne + 2*forwardOne - 0.5*forwardTwo;
-    float c = -0.5*backTwo + 0.5*forwardOne;
+    float a = -0.5f*backTwo + 1.5f*backOne - 1.5f*forwardOne + 0.5f * forwardTwo;
+    float b = backTwo - 2.5f*backOne + 2.0f*forwardOne - 0.5f*forwardTwo;
+    float c = -0.5f*backTwo + 0.5f*forwardOne;
     float d = backOne;
-    return (a*pow(x, 3)) + (b*pow(x, 2)) + (c*x) + d;
+    return ((a*x + b)*x + c)*x + d;//a*x^3 + b*x^2 + c*x + d, without pow()
 };
 
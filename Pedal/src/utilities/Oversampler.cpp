@@ -0,0 +1,297 @@
+#include "pedal/Oversampler.hpp"
+#include <complex>
+#include "pedal/Resampler.hpp"
+
+namespace{
+const double stopBandIIR = 90.0;//dB, sections are added until the stop band is this far down
+const double stopBandLinearPhase = 90.0;//dB, for the length (the kaiser window in windowedSinc reaches about 80dB)
+//magnitude of an allpass half-band at 'frequency' (a fraction of the higher rate)
+double halfBandMagnitude(const std::vector<double>& coefficients, double frequency){
+  std::complex<double> delay = std::polar(1.0, -2.0 * M_PI * frequency);//z^-1
+  std::complex<double> delay2 = delay * delay;
+  std::complex<double> branches[2] = {1.0, 1.0};
+  for(size_t k = 0; k < coefficients.size(); k++){
+    branches[k % 2] *= (coefficients[k] + delay2) / (1.0 + coefficients[k] * delay2);
+  }
+  return std::abs(0.5 * (branches[0] + delay * branches[1]));
+}
+//an elliptic half-band as a pair of allpass chains, 'transition' wide around a
+//quarter of the sample rate (after Laurent de Soras' HIIR)
+std::vector<double> allpassHalfBand(int numberCoefficients, double transition){
+  double k = std::tan((1.0 - 2.0 * transition) * M_PI / 4.0);
+  k *= k;
+  double kRoot = std::pow(1.0 - k * k, 0.25);
+  double e = 0.5 * (1.0 - kRoot) / (1.0 + kRoot);
+  double e4 = e * e * e * e;
+  double q = e * (1.0 + e4 * (2.0 + e4 * (15.0 + 150.0 * e4)));//elliptic nome
+  int order = numberCoefficients * 2 + 1;
+  std::vector<double> coefficients(numberCoefficients);
+  for(int index = 0; index < numberCoefficients; index++){
+    int c = index + 1;
+    double numerator = 0.0;
+    double sign = 1.0;
+    for(int i = 0; i < 64; i++){
+      double term = std::pow(q, i * (i + 1)) * std::sin((i * 2 + 1) * c * M_PI / order) * sign;
+      numerator += term;
+      sign = -sign;
+      if(std::fabs(term) < 1.0e-100){break;}
+    }
+    numerator *= std::pow(q, 0.25);
+    double denominator = 0.5;
+    sign = -1.0;
+    for(int i = 1; i < 64; i++){
+      double term = std::pow(q, i * i) * std::cos(i * 2 * c * M_PI / order) * sign;
+      denominator += term;
+      sign = -sign;
+      if(std::fabs(term) < 1.0e-100){break;}
+    }
+    double w = numerator / denominator;
+    double w2 = w * w;
+    double x = std::sqrt((1.0 - w2 * k) * (1.0 - w2 / k)) / (1.0 + w2);
+    coefficients[index] = (1.0 - x) / (1.0 + x);
+  }
+  return coefficients;
+}
+}
+
+Oversampler::Oversampler(int initialFactor, Filter initialFilter, int initialMaximumBlockSize){
+  maximumBlockSize = std::max(initialMaximumBlockSize, 1);
+  filter = initialFilter;
+  setFactor(initialFactor);//also designs the filters
+}
+
+void Oversampler::upsample(const float* input, float* output, int numberOfSamples){
+  for(int start = 0; start < numberOfSamples; start += maximumBlockSize){
+    int length = std::min(maximumBlockSize, numberOfSamples - start);
+    upsampleBlock(input + start, output + start * factor, length);
+  }
+}
+void Oversampler::downsample(const float* input, float* output, int numberOfSamples){
+  for(int start = 0; start < numberOfSamples; start += maximumBlockSize){
+    int length = std::min(maximumBlockSize, numberOfSamples - start);
+    downsampleBlock(input + start * factor, output + start, length);
+  }
+}
+void Oversampler::upsampleBlock(const float* input, float* output, int numberOfSamples){
+  if(numberStages == 0){
+    if(input != output){std::copy(input, input + numberOfSamples, output);}
+    return;
+  }
+  for(int s = 0; s < numberStages; s++){
+    const float* stageInput = (s == 0) ? input : stages[s - 1].between.data();
+    float* stageOutput = (s == numberStages - 1) ? output : stages[s].between.data();
+    upsampleStage(stages[s], stageInput, stageOutput, numberOfSamples << s);
+  }
+}
+void Oversampler::downsampleBlock(const float* input, float* output, int numberOfSamples){
+  if(numberStages == 0){
+    if(input != output){std::copy(input, input + numberOfSamples, output);}
+    return;
+  }
+  int length = numberOfSamples * factor;
+  if(padding > 0){//delay the highest rate a little, see design()
+    std::copy(input, input + length, padded.begin() + padding);
+    input = padded.data();
+  }
+  for(int s = numberStages - 1; s >= 0; s--){
+    const float* stageInput = (s == numberStages - 1) ? input : stages[s].between.data();
+    float* stageOutput = (s == 0) ? output : stages[s - 1].between.data();
+    downsampleStage(stages[s], stageInput, stageOutput, numberOfSamples << s);
+  }
+  if(padding > 0){
+    std::copy(padded.begin() + length, padded.begin() + length + padding, padded.begin());
+  }
+}
+
+void Oversampler::upsampleStage(HalfBand& band, const float* input, float* output, int numberOfSamples){
+  if(filter == Filter::IIR){
+    const float* coefficients = band.coefficients.data();
+    float* state = band.upState.data();
+    int sections = static_cast<int>(band.coefficients.size());
+    for(int i = 0; i < numberOfSamples; i++){
+      float first = input[i];
+      float second = input[i];
+      for(int k = 0; k < sections; k += 2){
+        first = allpass(first, coefficients[k], state + 2 * k);
+      }
+      for(int k = 1; k < sections; k += 2){
+        second = allpass(second, coefficients[k], state + 2 * k);
+      }
+      output[2 * i] = first;
+      output[2 * i + 1] = second;
+    }
+    return;
+  }
+  //LINEAR_PHASE: even outputs are the filter, odd outputs are the center tap
+  int m = band.halfOrder;
+  int history = 2 * m + 1;
+  float* samples = band.upInput.data();
+  std::copy(input, input + numberOfSamples, samples + history);
+  float* sum = band.sum.data();
+  std::fill(sum, sum + numberOfSamples, 0.0f);
+  //one tap at a time over the whole block (rather than one sample at a time)
+  //so the inner loop has no dependencies and can use SIMD. The taps are
+  //symmetrical, so each pair shares a multiply
+  for(int t = 0; t <= m; t++){
+    float tap = 2.0f * band.taps[t];//2.0 makes up for the inserted 0.0s
+    const float* newer = samples + history - t;
+    const float* older = samples + t;//history - (2m + 1 - t)
+    for(int i = 0; i < numberOfSamples; i++){
+      sum[i] += tap * (newer[i] + older[i]);
+    }
+  }
+  const float* center = samples + history - m;
+  for(int i = 0; i < numberOfSamples; i++){
+    output[2 * i] = sum[i];
+    output[2 * i + 1] = center[i];
+  }
+  std::copy(samples + numberOfSamples, samples + numberOfSamples + history, samples);
+}
+void Oversampler::downsampleStage(HalfBand& band, const float* input, float* output, int numberOfSamples){
+  if(filter == Filter::IIR){
+    const float* coefficients = band.coefficients.data();
+    float* state = band.downState.data();
+    int sections = static_cast<int>(band.coefficients.size());
+    for(int i = 0; i < numberOfSamples; i++){
+      float first = input[2 * i + 1];
+      float second = input[2 * i];
+      for(int k = 0; k < sections; k += 2){
+        first = allpass(first, coefficients[k], state + 2 * k);
+      }
+      for(int k = 1; k < sections; k += 2){
+        second = allpass(second, coefficients[k], state + 2 * k);
+      }
+      output[i] = 0.5f * (first + second);
+    }
+    return;
+  }
+  //LINEAR_PHASE: the even inputs are filtered, the odd inputs only meet the center tap
+  int m = band.halfOrder;
+  int evenHistory = 2 * m + 1;
+  int oddHistory = m + 1;
+  float* even = band.downEven.data();
+  float* odd = band.downOdd.data();
+  for(int i = 0; i < numberOfSamples; i++){
+    even[evenHistory + i] = input[2 * i];
+    odd[oddHistory + i] = input[2 * i + 1];
+  }
+  const float* center = odd;//oddHistory - (m + 1)
+  for(int i = 0; i < numberOfSamples; i++){
+    output[i] = 0.5f * center[i];
+  }
+  for(int t = 0; t <= m; t++){
+    float tap = band.taps[t];
+    const float* newer = even + evenHistory - t;
+    const float* older = even + t;
+    for(int i = 0; i < numberOfSamples; i++){
+      output[i] += tap * (newer[i] + older[i]);
+    }
+  }
+  std::copy(even + numberOfSamples, even + numberOfSamples + evenHistory, even);
+  std::copy(odd + numberOfSamples, odd + numberOfSamples + oddHistory, odd);
+}
+
+void Oversampler::reset(){
+  for(HalfBand& band : stages){
+    std::fill(band.upInput.begin(), band.upInput.end(), 0.0f);
+    std::fill(band.downEven.begin(), band.downEven.end(), 0.0f);
+    std::fill(band.downOdd.begin(), band.downOdd.end(), 0.0f);
+    std::fill(band.upState.begin(), band.upState.end(), 0.0f);
+    std::fill(band.downState.begin(), band.downState.end(), 0.0f);
+  }
+  std::fill(padded.begin(), padded.end(), 0.0f);
+}
+
+void Oversampler::design(){
+  stages.assign(numberStages, HalfBand());
+  float topRateLatency = 0.0f;//in samples at the highest rate
+  for(int s = 0; s < numberStages; s++){
+    HalfBand& band = stages[s];
+    band.blockSize = maximumBlockSize << s;
+    if(s < numberStages - 1){band.between.resize(band.blockSize * 2);}
+    //pass band to 90% of the original nyquist, as a fraction of this stage's higher rate
+    float passBand = 0.45f / static_cast<float>(2 << s);
+    float transition = 2.0f * (0.25f - passBand);
+    float stageLatency;//up and back down, at this stage's higher rate
+    if(filter == Filter::IIR){
+      designIIR(band, transition);
+      //each section delays low frequencies by (1 - c)/(1 + c) samples at the lower
+      //rate. The half sample between the branches is taken back by downsampleStage(),
+      //which pairs each odd sample with the even sample before it
+      stageLatency = 0.0f;
+      for(float coefficient : band.coefficients){
+        stageLatency += 2.0f * (1.0f - coefficient) / (1.0f + coefficient);
+      }
+    }else{
+      designLinearPhase(band, transition);
+      stageLatency = static_cast<float>(4 * band.halfOrder + 2);
+    }
+    topRateLatency += stageLatency * static_cast<float>(factor >> (s + 1));
+  }
+  padding = 0;
+  if(filter == Filter::LINEAR_PHASE && numberStages > 0){
+    //a little more delay at the highest rate makes the total a whole sample
+    int total = static_cast<int>(topRateLatency);
+    padding = (factor - total % factor) % factor;
+    topRateLatency += static_cast<float>(padding);
+  }
+  padded.assign(padding > 0 ? maximumBlockSize * factor + padding : 0, 0.0f);
+  latency = topRateLatency / static_cast<float>(factor);
+  oversampled.assign(maximumBlockSize * factor, 0.0f);
+}
+void Oversampler::designLinearPhase(HalfBand& band, float transition){
+  //kaiser estimate of the length, rounded up to 4m + 3
+  double length = (stopBandLinearPhase - 7.95) / (14.36 * transition) + 1.0;
+  int m = std::max(static_cast<int>(std::ceil((length - 3.0) / 4.0)), 0);
+  int taps = 4 * m + 3;
+  band.halfOrder = m;
+  //windowedSinc makes an even length centered between two taps; with one extra
+  //tap the last is 0.0 and the rest are centered on tap 2m + 1
+  std::vector<float> prototype(taps + 1);
+  Resampler::windowedSinc(prototype.data(), taps + 1, 0.25, 0.0);
+  //keep the even taps (the odd ones, other than the center, are 0.0), renormalised
+  //so the center is exactly 0.5 and each phase has unity gain
+  double sum = 0.0;
+  for(int t = 0; t < taps; t += 2){sum += prototype[t];}
+  band.taps.resize(m + 1);//the other half mirrors these
+  for(int t = 0; t <= m; t++){
+    band.taps[t] = static_cast<float>(0.5 * prototype[2 * t] / sum);
+  }
+  band.upInput.assign(band.blockSize + 2 * m + 1, 0.0f);
+  band.downEven.assign(band.blockSize + 2 * m + 1, 0.0f);
+  band.downOdd.assign(band.blockSize + m + 1, 0.0f);
+  band.sum.assign(band.blockSize, 0.0f);
+}
+void Oversampler::designIIR(HalfBand& band, float transition){
+  //add sections until the stop band (from 0.25 + transition / 2 to 0.5) is low enough
+  std::vector<double> coefficients;
+  for(int numberCoefficients = 1; numberCoefficients <= 16; numberCoefficients++){
+    coefficients = allpassHalfBand(numberCoefficients, transition);
+    double loudest = 0.0;
+    for(int i = 0; i <= 200; i++){
+      double frequency = 0.25 + transition * 0.5 + (0.25 - transition * 0.5) * i / 200.0;
+      loudest = std::max(loudest, halfBandMagnitude(coefficients, frequency));
+    }
+    if(20.0 * std::log10(loudest) <= -stopBandIIR){break;}
+  }
+  band.coefficients.assign(coefficients.begin(), coefficients.end());
+  band.upState.assign(coefficients.size() * 2, 0.0f);
+  band.downState.assign(coefficients.size() * 2, 0.0f);
+}
+
+void Oversampler::setFactor(int newFactor){
+  numberStages = 0;
+  while((1 << numberStages) < newFactor && numberStages < 3){numberStages++;}
+  factor = 1 << numberStages;
+  design();
+}
+void Oversampler::setFilter(Filter newFilter){
+  filter = newFilter;
+  design();
+}
+
+int Oversampler::getFactor(){return factor;}
+Oversampler::Filter Oversampler::getFilter(){return filter;}
+int Oversampler::getMaximumBlockSize(){return maximumBlockSize;}
+int Oversampler::getLatencyInSamples(){return static_cast<int>(latency + 0.5f);}
+float Oversampler::getLatency(){return latency;}
@@ -0,0 +1,139 @@
+#include "pedal/Resampler.hpp"
+#include <atomic>
+#include <thread>
+
+namespace{
+unsigned long long greatestCommonDivisor(unsigned long long a, unsigned long long b){
+  while(b != 0){
+    unsigned long long remainder = a % b;
+    a = b;
+    b = remainder;
+  }
+  return a;
+}
+//modified Bessel function of the first kind, used by the kaiser window
+double besselI0(double x){
+  double sum = 1.0;
+  double term = 1.0;
+  for(int k = 1; k < 50; k++){
+    term *= (x / (2.0 * k)) * (x / (2.0 * k));
+    sum += term;
+    if(term < sum * 1.0e-12){break;}
+  }
+  return sum;
+}
+}
+
+Resampler::Resampler(unsigned initialInputRate, unsigned initialOutputRate, int tapsPerPhase){
+  inputRate = std::max(initialInputRate, 1u);
+  outputRate = std::max(initialOutputRate, 1u);
+  unsigned long long divisor = greatestCommonDivisor(inputRate, outputRate);
+  upFactor = outputRate / divisor;
+  downFactor = inputRate / divisor;
+  numberOfPhases = static_cast<int>(std::min<unsigned long long>(upFactor, 4096));
+  //when lowering the rate the filter must be longer (narrower in frequency)
+  taps = std::max(tapsPerPhase, 4);
+  if(outputRate < inputRate){
+    taps = std::min(static_cast<int>(taps * (static_cast<double>(inputRate) / outputRate) + 0.5), 512);
+  }
+  taps += taps % 2;//even, so the filter is centered between two input samples
+  designFilter();
+}
+void Resampler::designFilter(){
+  //the filter fades from pass to stop over 'transition' (a fraction of the
+  //lower sample rate), which should end at the lower of the two nyquist frequencies
+  double lowerRateTaps = taps * std::min(1.0, static_cast<double>(outputRate) / inputRate);
+  double transition = (80.0 - 7.95) / (14.36 * lowerRateTaps);
+  double cutoff = (0.5 - transition * 0.5) * std::min(1.0, static_cast<double>(outputRate) / inputRate);
+  filter.resize(numberOfPhases * taps);
+  for(int phase = 0; phase < numberOfPhases; phase++){
+    double fraction = static_cast<double>(phase) / numberOfPhases;//position between samples
+    windowedSinc(&filter[phase * taps], taps, cutoff, fraction);
+  }
+}
+void Resampler::windowedSinc(float* coefficients, int taps, double cutoff, double fraction){
+  const double beta = 8.0;//kaiser window shape, about -80dB stop band
+  double windowScalar = 1.0 / besselI0(beta);
+  int halfTaps = taps / 2;
+  double sum = 0.0;
+  for(int k = 0; k < taps; k++){
+    double distance = (k - halfTaps + 1) - fraction;//from output point to input sample
+    double x = 2.0 * M_PI * cutoff * distance;
+    double sinc = (std::fabs(x) < 1.0e-9) ? 1.0 : std::sin(x) / x;
+    double ratio = distance / halfTaps;
+    double window = std::fabs(ratio) < 1.0 ? besselI0(beta * std::sqrt(1.0 - ratio * ratio)) * windowScalar : 0.0;
+    coefficients[k] = static_cast<float>(sinc * window);
+    sum += coefficients[k];
+  }
+  for(int k = 0; k < taps; k++){//unity gain at 0Hz
+    coefficients[k] = static_cast<float>(coefficients[k] / sum);
+  }
+}
+unsigned long Resampler::getOutputLength(unsigned long inputLength){
+  return static_cast<unsigned long>((inputLength * upFactor + downFactor - 1) / downFactor);
+}
+void Resampler::process(const float* input, unsigned long inputFrames, float* output,
+                        int numberOfChannels, int numberOfThreads){
+  numberOfChannels = std::max(numberOfChannels, 1);
+  unsigned long outputFrames = getOutputLength(inputFrames);
+  //separate the channels so every filter reads neighbouring samples
+  std::vector<float> planarInput(inputFrames * numberOfChannels);
+  for(unsigned long i = 0; i < inputFrames; i++){
+    for(int channel = 0; channel < numberOfChannels; channel++){
+      planarInput[channel * inputFrames + i] = input[i * numberOfChannels + channel];
+    }
+  }
+  //every chunk of every channel is independent
+  const unsigned long framesPerChunk = 65536;
+  unsigned long chunksPerChannel = (outputFrames + framesPerChunk - 1) / framesPerChunk;
+  long totalChunks = static_cast<long>(chunksPerChannel * numberOfChannels);
+  std::atomic<long> nextChunk(0);
+  auto work = [&](){
+    for(long chunk = nextChunk++; chunk < totalChunks; chunk = nextChunk++){
+      int channel = static_cast<int>(chunk / chunksPerChannel);
+      unsigned long start = (chunk % chunksPerChannel) * framesPerChunk;
+      unsigned long end = std::min(start + framesPerChunk, outputFrames);
+      processChunk(&planarInput[channel * inputFrames], inputFrames, output,
+                   numberOfChannels, channel, start, end);
+    }
+  };
+  if(numberOfThreads <= 0){
+    numberOfThreads = static_cast<int>(std::thread::hardware_concurrency());
+  }
+  numberOfThreads = static_cast<int>(clamp<long>(numberOfThreads, 1, std::max(totalChunks, 1L)));
+  std::vector<std::thread> helpers;
+  for(int i = 1; i < numberOfThreads; i++){//the calling thread is the first thread
+    helpers.emplace_back(work);
+  }
+  work();
+  for(std::thread& helper : helpers){helper.join();}
+}
+void Resampler::processChunk(const float* channelInput, unsigned long inputFrames, float* output,
+                             int numberOfChannels, int channel, unsigned long start, unsigned long end){
+  const long halfTaps = taps / 2;
+  for(unsigned long n = start; n < end; n++){
+    //output sample n falls at input position n * down / up
+    unsigned long long numerator = n * downFactor;
+    long base = static_cast<long>(numerator / upFactor);
+    int phase = static_cast<int>((numerator % upFactor) * numberOfPhases / upFactor);
+    const float* coefficients = &filter[phase * taps];
+    long first = base - halfTaps + 1;//first input sample under the filter
+    float sum = 0.0f;
+    if(first >= 0 && first + taps <= static_cast<long>(inputFrames)){
+      const float* samples = channelInput + first;
+      for(int k = 0; k < taps; k++){
+        sum += samples[k] * coefficients[k];
+      }
+    }else{//near either end, samples outside the signal are silent
+      for(int k = 0; k < taps; k++){
+        long index = first + k;
+        if(index >= 0 && index < static_cast<long>(inputFrames)){
+          sum += channelInput[index] * coefficients[k];
+        }
+      }
+    }
+    output[n * numberOfChannels + channel] = sum;
+  }
+}
+unsigned Resampler::getInputRate(){return inputRate;}
+unsigned Resampler::getOutputRate(){return outputRate;}
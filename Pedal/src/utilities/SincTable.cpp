@@ -0,0 +1,40 @@
+#include "pedal/SincTable.hpp"
+#include "pedal/Resampler.hpp"
+
+const SincTable& SincTable::get(){
+  static const SincTable table;//thread safe initialisation
+  return table;
+}
+SincTable::SincTable(){
+  for(int level = 0; level < levels; level++){
+    //the cutoff falls by half an octave per level, and the filter grows to match
+    double speedLimit = std::pow(2.0, level * 0.5);
+    taps[level] = ((static_cast<int>(32.0 * speedLimit + 0.5) + 7) / 8) * 8;
+    //end the transition band at the new nyquist, as Resampler does
+    double transition = (80.0 - 7.95) / (14.36 * taps[level] / speedLimit);
+    double cutoff = (0.5 - transition * 0.5) / speedLimit;
+    filters[level].resize((phases + 1) * taps[level]);
+    for(int phase = 0; phase <= phases; phase++){
+      Resampler::windowedSinc(&filters[level][phase * taps[level]], taps[level], cutoff,
+                              static_cast<double>(phase) / phases);
+    }
+  }
+}
+int SincTable::getLevel(float speed) const {
+  speed = std::fabs(speed);
+  if(speed <= 1.0f){return 0;}
+  //half octaves above 1x, rounded up (a little tolerance, so exactly 2x is level 2)
+  int level = static_cast<int>(std::ceil(2.0f * std::log2(speed) - 1.0e-4f));
+  return clamp(level, 0, levels - 1);
+}
+int SincTable::getTaps(int level) const {return taps[level];}
+void SincTable::getWeights(int level, float position, float* weights) const {
+  float scaledPosition = clamp(position, 0.0f, 1.0f) * phases;
+  int phase = std::min(static_cast<int>(scaledPosition), phases - 1);
+  float mix = scaledPosition - phase;
+  const float* before = &filters[level][phase * taps[level]];
+  const float* after = before + taps[level];
+  for(int k = 0; k < taps[level]; k++){
+    weights[k] = before[k] + (after[k] - before[k]) * mix;
+  }
+}
@@ -33,15 +33,7 @@ float samplesToMS(float samples){
 //amplitudeToDB is in header since templated
 //dBToAmplitude is in header since templated
 
-//pan input from left to right, position range -1 to 1
-void panStereo(float input, float position, float* outputFrame){
-  //convert to radians
-  float theta = clamp(position, -1.0f, 1.0f) * M_PI * 0.25f * -1.0f;
-  float cosTheta = std::cos(theta);
-  float sinTheta = std::sin(theta);
-  outputFrame[0] = M_SQRT1_2 * (sinTheta - cosTheta) * input;
-  outputFrame[1] = M_SQRT1_2 * (sinTheta + cosTheta) * input;
-}
+//panStereo is in header since inlined
 /* //function unnecessary, will be moved to buffer class
 void normalizeBuffer(float* inputBuffer, int bufferSize, bool correctDC = true){
   float highestValue;